@@ -11,8 +11,12 @@
 // =========================================================================================== IMPORT
 
 #include <stdbool.h>
+#include <limits.h>
+#include <math.h>
 #include "soc/gpio_reg.h"
 #include "soc/gpio_struct.h"
+#include "esp_timer.h"
+#include "esp_sleep.h"
 
 
 // Header import
@@ -38,6 +42,10 @@
 
 // =========================================================================================== HELPER FUNCTIONS
 
+// E12 preferred numbers series (values * 100) for the encoder_lut_series_fill function
+const uint16_t ENC_E12_SERIES[12] = { 100, 120, 150, 180, 220, 270, 330, 390, 470, 560, 680, 820 };
+
+
 // Low-level read function
 static inline int fast_gpio_read(int pin)
 {
@@ -47,479 +55,2044 @@ static inline int fast_gpio_read(int pin)
         return (GPIO.in1.val >> (pin - 32)) & 0x1;
 }
 
-// =========================================================================================== HELPER FUNCTIONS
 
+// Pin state from the already read input registers values
+static inline bool gpio_snapshot_bit(uint32_t in, uint32_t in1, gpio_num_t pin)
+{
+    if (pin == GPIO_PIN_NONE) return false;
 
-// =========================================================================================== API DEFINITION SECTION
+    if (pin < 32)
+        return (in >> pin) & 0x1;
+    else
+        return (in1 >> (pin - 32)) & 0x1;
+}
 
-// Creates and initializes an encoder context
-void encoder_initialization(encoder_ctx *encoder,
-    gpio_num_t vcc_pin,
-    gpio_num_t gnd_pin,
-    gpio_num_t sw_pin,
-    gpio_num_t dt_pin,
-    gpio_num_t clk_pin) {
 
-    // Error handler
-    if (!encoder) return;
+// Low-level write function (set/clear registers without the read-modify-write)
+static inline void fast_gpio_write(int pin, bool level)
+{
+    if (pin < 32)
+    {
+        if (level) GPIO.out_w1ts = 1u << pin;
+        else GPIO.out_w1tc = 1u << pin;
+    }
+    else
+    {
+        if (level) GPIO.out1_w1ts.val = 1u << (pin - 32);
+        else GPIO.out1_w1tc.val = 1u << (pin - 32);
+    }
+}
 
-    // Default context values with initialization by the function
-    *encoder = encoder_ctx_default();
-    
-    // Pins adding into context
-    encoder->ENC_VCC = vcc_pin;
-    encoder->ENC_GND = gnd_pin;
-    encoder->ENC_SW = sw_pin;
-    encoder->ENC_DT = dt_pin;
-    encoder->ENC_CLK = clk_pin;
 
-    // Debounce await for the rotation
-    encoder->ENC_AWAIT = async_await_ctx_default();
+// Line state from the scan bus snapshot
+static inline bool scan_snapshot_bit(const encoder_scan_bus *bus, gpio_num_t line)
+{
+    if (line == GPIO_PIN_NONE || line >= bus->lines) return false;
 
-    // Pins setup, depending on the values passed as function arguments
-    // Encoder VCC initialization
-    if (encoder->ENC_VCC != GPIO_PIN_NONE)
+    return (bus->snapshot[line >> 3] >> (line & 7)) & 0x1;
+}
+
+
+// Encoder input from the last scan bus burst (the pins of the scanned encoder are the bus lines)
+static inline void enc_scan_input_read(const encoder_ctx *encoder, encoder_input_snapshot *input)
+{
+    const encoder_scan_bus *bus = encoder->scan_bus;
+
+    input->clk = scan_snapshot_bit(bus, encoder->ENC_CLK);
+    input->dt = scan_snapshot_bit(bus, encoder->ENC_DT);
+    input->sw = (encoder->ENC_SW != GPIO_PIN_NONE) && !scan_snapshot_bit(bus, encoder->ENC_SW);
+    input->z = scan_snapshot_bit(bus, encoder->ENC_Z);
+}
+
+
+// One input registers read for all the encoder pins (or the scan bus snapshot for the scanned encoder)
+// SW is active low (pull-up), so the snapshot stores the pressed state
+static inline void enc_input_read(const encoder_ctx *encoder, encoder_input_snapshot *input)
+{
+    if (encoder->scan_bus)
     {
-        gpio_set_direction(encoder->ENC_VCC, GPIO_MODE_OUTPUT);
-        gpio_set_level(encoder->ENC_VCC, 1);
+        enc_scan_input_read(encoder, input);
+        return;
     }
 
-    // Encoder GND initialization
-    if (encoder->ENC_GND != GPIO_PIN_NONE)
+    uint32_t in = GPIO.in;
+    uint32_t in1 = GPIO.in1.val;
+
+    input->clk = gpio_snapshot_bit(in, in1, encoder->ENC_CLK);
+    input->dt = gpio_snapshot_bit(in, in1, encoder->ENC_DT);
+    input->sw = (encoder->ENC_SW != GPIO_PIN_NONE) && !gpio_snapshot_bit(in, in1, encoder->ENC_SW);
+    input->z = gpio_snapshot_bit(in, in1, encoder->ENC_Z);
+}
+
+
+// Common time base of the encoder control (microseconds)
+static inline int64_t enc_time_now_us(void)
+{
+    return esp_timer_get_time();
+}
+
+
+// Parameter values compare by the selected type. Returns -1 if a < b, 0 if a == b, 1 if a > b
+static inline int par_value_compare(parameter_type type, const parameter_value_union *a, const parameter_value_union *b)
+{
+    switch (type)
     {
-        gpio_set_direction(encoder->ENC_GND, GPIO_MODE_OUTPUT);
-        gpio_set_level(encoder->ENC_GND, 0);
+        case TYPE_UNS_INT: return (a->uns_int > b->uns_int) - (a->uns_int < b->uns_int);
+        case TYPE_INT: return (a->int_val > b->int_val) - (a->int_val < b->int_val);
+        case TYPE_UINT_8: return (a->u8 > b->u8) - (a->u8 < b->u8);
+        case TYPE_UINT_16: return (a->u16 > b->u16) - (a->u16 < b->u16);
+        case TYPE_UINT_32: return (a->u32 > b->u32) - (a->u32 < b->u32);
+        case TYPE_UINT_64: return (a->u64 > b->u64) - (a->u64 < b->u64);
+        case TYPE_FLOAT: return (a->f > b->f) - (a->f < b->f);
+        default: return 0;
     }
+}
 
-    // Encoder SW initialization
-    if (encoder->ENC_SW != GPIO_PIN_NONE)
+
+// Index of the parameter inside the bound parameters table (ENC_PARAMETER_DIRECT for the other parameters)
+static inline uint8_t enc_parameter_index(const encoder_ctx *encoder, const encoder_parameter *par)
+{
+    if (encoder->parameter_table && par >= encoder->parameter_table && par < encoder->parameter_table + encoder->parameter_count)
+        return (uint8_t)(par - encoder->parameter_table);
+
+    return ENC_PARAMETER_DIRECT;
+}
+
+
+// Dirty bit set for the changed parameter: base bit + table index (base bit for the other parameters)
+static inline void enc_dirty_mark(encoder_ctx *encoder, const encoder_parameter *par)
+{
+    if (!encoder->dirty_map) return;
+
+    uint8_t index = enc_parameter_index(encoder, par);
+
+    encoder_dirty_set(encoder->dirty_map, encoder->dirty_base_bit + ((index == ENC_PARAMETER_DIRECT) ? 0 : index));
+}
+
+
+// Event adding into the encoder events queue with the coalescing by the pending event of the same type and parameter
+// (the parameter pointer - the standalone parameters share ENC_PARAMETER_DIRECT index, but not the events)
+static void enc_event_push(encoder_ctx *encoder, encoder_event_type type, int32_t delta)
+{
+    // Event value source - the last controlled parameter (empty parameter before the first control call)
+    static const encoder_parameter no_parameter = {0};
+    const encoder_parameter *value_source = encoder->active_parameter ? encoder->active_parameter : &no_parameter;
+    uint8_t parameter_index = enc_parameter_index(encoder, encoder->active_parameter);
+
+    // Search of the pending event with the same type
+    for (uint8_t i = 0; i < encoder->event_count; i++)
     {
-        encoder->sw_button = button_initialization(encoder->ENC_SW, GPIO_PULLUP_ONLY, NO_FIX);
+        encoder_event *pending = &encoder->event_queue[(encoder->event_head + i) % ENC_EVENT_QUEUE_SIZE];
+
+        // Coalescing: net delta and the final value only
+        if (pending->type == type && pending->parameter == encoder->active_parameter)
+        {
+            pending->delta += delta;
+            pending->value_type = value_source->type;
+            pending->value = value_source->parameter;
+
+            return;
+        }
     }
 
-    // Encoder DT initialization
-    if (encoder->ENC_DT != GPIO_PIN_NONE)
+    // Error handler for the full queue
+    if (encoder->event_count >= ENC_EVENT_QUEUE_SIZE)
     {
-        gpio_set_direction(encoder->ENC_DT, GPIO_MODE_INPUT);
-        gpio_set_pull_mode(encoder->ENC_DT, GPIO_PULLUP_ONLY);
+        encoder->events_dropped++;
+        return;
     }
 
-    // Encoder CLK initialization
-    if (encoder->ENC_CLK != GPIO_PIN_NONE)
+    // New event at the queue tail
+    encoder_event *event = &encoder->event_queue[(encoder->event_head + encoder->event_count) % ENC_EVENT_QUEUE_SIZE];
+
+    event->type = type;
+    event->delta = delta;
+    event->parameter = encoder->active_parameter;
+    event->parameter_index = parameter_index;
+    event->value_type = value_source->type;
+    event->value = value_source->parameter;
+
+    encoder->event_count++;
+}
+
+
+// Pending event value refresh by the active parameter (without the new event)
+static void enc_event_value_update(encoder_ctx *encoder, encoder_event_type type)
+{
+    // Error handler
+    if (!encoder->active_parameter) return;
+
+    for (uint8_t i = 0; i < encoder->event_count; i++)
     {
-        gpio_set_direction(encoder->ENC_CLK, GPIO_MODE_INPUT);
-        gpio_set_pull_mode(encoder->ENC_CLK, GPIO_PULLUP_ONLY);
+        encoder_event *pending = &encoder->event_queue[(encoder->event_head + i) % ENC_EVENT_QUEUE_SIZE];
+
+        if (pending->type == type && pending->parameter == encoder->active_parameter)
+        {
+            pending->value = encoder->active_parameter->parameter;
+            return;
+        }
+    }
+}
 
 
-        // Initial CLK state for the enc_rotation_value_control function
-        encoder->last_clk_state = fast_gpio_read(encoder->ENC_CLK);
+// Controlled variable value check in compare with the cached parameter value
+static bool par_link_changed(const encoder_parameter *par)
+{
+    switch (par->type)
+    {
+        case TYPE_UNS_INT: return par->parameter.uns_int != *(unsigned int*)par->link;
+        case TYPE_INT: return par->parameter.int_val != *(int*)par->link;
+        case TYPE_UINT_8: return par->parameter.u8 != *(uint8_t*)par->link;
+        case TYPE_UINT_16: return par->parameter.u16 != *(uint16_t*)par->link;
+        case TYPE_UINT_32: return par->parameter.u32 != *(uint32_t*)par->link;
+        case TYPE_UINT_64: return par->parameter.u64 != *(uint64_t*)par->link;
+        case TYPE_FLOAT: return par->parameter.f != *(float*)par->link;
+        default: return false;
     }
+}
 
-    // Error handler
-    else encoder->last_clk_state = 0;
+
+// Controlled variable value loading into the cached parameter value by the parameter type
+static void par_link_load(encoder_parameter *par)
+{
+    switch (par->type)
+    {
+        case TYPE_UNS_INT: par->parameter.uns_int = *(unsigned int*)par->link; break;
+        case TYPE_INT: par->parameter.int_val = *(int*)par->link; break;
+        case TYPE_UINT_8: par->parameter.u8 = *(uint8_t*)par->link; break;
+        case TYPE_UINT_16: par->parameter.u16 = *(uint16_t*)par->link; break;
+        case TYPE_UINT_32: par->parameter.u32 = *(uint32_t*)par->link; break;
+        case TYPE_UINT_64: par->parameter.u64 = *(uint64_t*)par->link; break;
+        case TYPE_FLOAT: par->parameter.f = *(float*)par->link; break;
+    }
 }
 
 
-// Any type stepped parameter value control by the encoder rotation with the different side logic and different limitation logic
-void enc_rotation_value_control(encoder_ctx *encoder,
-    rotation_side side,
-    rotation_overflow_mode rotation_regime,
-    void *parameter,
-    parameter_type type,
-    void *step,
-    void *min_val,
-    void *max_val) {
-    
+// Table index step by one detent with the parameter overflow mode. Returns true for the index wrap
+// The value is taken from the precomputed table - one load without the runtime calculations
+static bool enc_lut_index_step(encoder_parameter *par, int8_t direction, uint16_t count)
+{
+    uint16_t last_index = par->lut_size - 1;
+    bool wrapped = false;
+
+    // Index increase with the table end overflow
+    if (direction > 0)
+    {
+        if (last_index - par->lut_index >= count) par->lut_index += count;
+        else if (par->overflow_mode == ROTATION) { par->lut_index = 0; wrapped = true; }
+        else par->lut_index = last_index;
+    }
+    // Index decrease with the table start overflow
+    else
+    {
+        if (par->lut_index >= count) par->lut_index -= count;
+        else if (par->overflow_mode == ROTATION) { par->lut_index = last_index; wrapped = true; }
+        else par->lut_index = 0;
+    }
+
+    par->parameter = par->lut[par->lut_index];
+
+    return wrapped;
+}
+
+
+// Regulation step scaling by the multiplier for the selected type (press-and-turn coarse step),
+// saturated at the type maximum instead of the silent wrap of the narrow types
+static parameter_value_union par_step_scale(parameter_type type, const parameter_value_union *step, uint16_t multiplier)
+{
+    parameter_value_union result = *step;
+
     // Error handler
-    if (encoder->ENC_CLK == GPIO_PIN_NONE || encoder->ENC_DT == GPIO_PIN_NONE) return;
-    
-    // Type error handler with the type setup
-    if (encoder->controlled_parameter_type != type) encoder->new_parameter_type = true;
-    
-    // Reset the values, regulated by encoder with type change
-    if (encoder->new_parameter_type)
+    if (multiplier <= 1) return result;
+
+    switch (type)
     {
-        // Set the new type inside the encoder context
-        encoder->controlled_parameter_type = type;
+        case TYPE_UNS_INT:
+            result.uns_int = (step->uns_int > UINT_MAX / multiplier) ? UINT_MAX : step->uns_int * multiplier;
+            break;
 
-        // Data converting by new the selected type with saving inside the storage 
-        par_type_converting(encoder, type, parameter, step, min_val, max_val);
+        case TYPE_INT:
+            if (step->int_val > INT_MAX / multiplier) result.int_val = INT_MAX;
+            else if (step->int_val < INT_MIN / multiplier) result.int_val = INT_MIN;
+            else result.int_val = step->int_val * multiplier;
+            break;
 
-        // Operation control flag change
-        encoder->new_parameter_type = false;
+        case TYPE_UINT_8:
+            result.u8 = (step->u8 > UINT8_MAX / multiplier) ? UINT8_MAX : (uint8_t)(step->u8 * multiplier);
+            break;
+
+        case TYPE_UINT_16:
+            result.u16 = (step->u16 > UINT16_MAX / multiplier) ? UINT16_MAX : (uint16_t)(step->u16 * multiplier);
+            break;
+
+        case TYPE_UINT_32:
+            result.u32 = (step->u32 > UINT32_MAX / multiplier) ? UINT32_MAX : step->u32 * multiplier;
+            break;
+
+        case TYPE_UINT_64:
+            result.u64 = (step->u64 > UINT64_MAX / multiplier) ? UINT64_MAX : step->u64 * multiplier;
+            break;
+
+        case TYPE_FLOAT: result.f *= multiplier; break;
     }
 
-    // Regulation parameters switch logic with type error handler
-    if (encoder->controlled_parameter_type == type && regulation_values_changed(encoder, type, parameter, step, min_val, max_val))
+    return result;
+}
+
+
+// Float value converting into the parameter value by the parameter type (with the rounding for the integer types).
+// long is 32 bits on ESP32, so the unsigned 32-bit types are rounded by llroundf (lroundf above LONG_MAX is undefined)
+static parameter_value_union par_value_from_float(parameter_type type, float value)
+{
+    parameter_value_union result = {0};
+
+    switch (type)
     {
-        // Reset the parameters values with the additional type error processing
-        par_type_converting(encoder, type, parameter, step, min_val, max_val);
-    }   
+        case TYPE_UNS_INT: result.uns_int = (unsigned int)llroundf(value); break;
+        case TYPE_INT: result.int_val = (int)lroundf(value); break;
+        case TYPE_UINT_8: result.u8 = (uint8_t)lroundf(value); break;
+        case TYPE_UINT_16: result.u16 = (uint16_t)lroundf(value); break;
+        case TYPE_UINT_32: result.u32 = (uint32_t)llroundf(value); break;
+        case TYPE_UINT_64: result.u64 = (uint64_t)llroundf(value); break;
+        case TYPE_FLOAT: result.f = value; break;
+    }
 
+    return result;
+}
 
-    // ENCODER CONTROL LOOP START
 
-    // Get the encoder clk pin state
-    int clk_state = fast_gpio_read(encoder->ENC_CLK);
+// Input activity update by the snapshot: last activity time, polls counter and the idle exit to the first poll time
+static void enc_activity_update(encoder_ctx *encoder, const encoder_input_snapshot *input, int64_t now_us)
+{
+    encoder->power_stats.polls++;
 
-    // Compare current clk state with the last clk state value, and if it's changed
-    if (clk_state != encoder->last_clk_state && clk_state == 1)
+    bool changed = input->clk != encoder->last_input.clk || input->dt != encoder->last_input.dt ||
+                   input->sw != encoder->last_input.sw || input->z != encoder->last_input.z;
+
+    // First poll after the idle sleep exit: the delay is measured only for the wakeup by the encoder
+    // (input differs from the pre-sleep snapshot), the wakeups by the other sources are not counted
+    if (encoder->exit_poll_pending)
     {
-        // If the code pass through the debounce await
-        if (async_await(&encoder->ENC_AWAIT, 3, TIME_UNIT_MS, false))
+        if (changed)
         {
-            // Get the encoder dt pin state
-            int dt_state = fast_gpio_read(encoder->ENC_DT);
-
-            // If we choose parameter increase with counterclockwise rotation
-            if (side == CLOCKWISE)
-            {
-                // If we fixed the difference of dt state in compare with clk state
-                if (dt_state != clk_state)
-                {
-                    // Summarize the step value and current parameter value by the current type
-                    switch (encoder->controlled_parameter_type)
-                    {
-                        case TYPE_UNS_INT: encoder->parameter.uns_int += encoder->step.uns_int; break;
-                        case TYPE_INT: encoder->parameter.int_val += encoder->step.int_val; break;
-                        case TYPE_UINT_8: encoder->parameter.u8 += encoder->step.u8; break;
-                        case TYPE_UINT_16: encoder->parameter.u16 += encoder->step.u16; break;
-                        case TYPE_UINT_32: encoder->parameter.u32 += encoder->step.u32; break;
-                        case TYPE_UINT_64: encoder->parameter.u64 += encoder->step.u64; break;
-                        case TYPE_FLOAT: encoder->parameter.f += encoder->step.f; break;
-                    }
-                }
-                // If we fixed the equality of dt state in compare with clk state
-                else
-                {
-                    // Subtract the step value from the current parameter value by the current type
-                    // Switch with low-side limitation for LIMITATION overflow setting (else - we don't care 
-                    // about subtraction overflow for the unsigned types, cause it rotates to the maximal limit anyway)
-                    switch (encoder->controlled_parameter_type)
-                    {
-                        case TYPE_UNS_INT:
-                            if (rotation_regime == LIMITATION)
-                            {
-                                if (encoder->parameter.uns_int <= encoder->step.uns_int)
-                                    encoder->parameter.uns_int = encoder->min_val.uns_int;
-                                else
-                                    encoder->parameter.uns_int -= encoder->step.uns_int;
-                            }
-                            else
-                            {
-                                encoder->parameter.uns_int -= encoder->step.uns_int;
-                            }
-                            break;
-                        
-                        // Signed type don't requires a low-side limitation for LIMITATION overflow setting
-                        case TYPE_INT:
-                            encoder->parameter.int_val -= encoder->step.int_val;
-                            break;
-                    
-                        case TYPE_UINT_8:
-                            if (rotation_regime == LIMITATION)
-                            {
-                                if (encoder->parameter.u8 <= encoder->step.u8)
-                                    encoder->parameter.u8 = encoder->min_val.u8;
-                                else
-                                    encoder->parameter.u8 -= encoder->step.u8;
-                            }
-                            else
-                            {
-                                encoder->parameter.u8 -= encoder->step.u8;
-                            }
-                            break;
-                    
-                        case TYPE_UINT_16:
-                            if (rotation_regime == LIMITATION)
-                            {
-                                if (encoder->parameter.u16 <= encoder->step.u16)
-                                    encoder->parameter.u16 = encoder->min_val.u16;
-                                else
-                                    encoder->parameter.u16 -= encoder->step.u16;
-                            }
-                            else
-                            {
-                                encoder->parameter.u16 -= encoder->step.u16;
-                            }
-                            break;
-                    
-                        case TYPE_UINT_32:
-                            if (rotation_regime == LIMITATION)
-                            {
-                                if (encoder->parameter.u32 <= encoder->step.u32)
-                                    encoder->parameter.u32 = encoder->min_val.u32;
-                                else
-                                    encoder->parameter.u32 -= encoder->step.u32;
-                            }
-                            else
-                            {
-                                encoder->parameter.u32 -= encoder->step.u32;
-                            }
-                            break;
-                    
-                        case TYPE_UINT_64:
-                            if (rotation_regime == LIMITATION)
-                            {
-                                if (encoder->parameter.u64 <= encoder->step.u64)
-                                    encoder->parameter.u64 = encoder->min_val.u64;
-                                else
-                                    encoder->parameter.u64 -= encoder->step.u64;
-                            }
-                            else
-                            {
-                                encoder->parameter.u64 -= encoder->step.u64;
-                            }
-                            break;
-                        
-                        // Signed type don't requires a low-side limitation for LIMITATION overflow setting
-                        case TYPE_FLOAT:
-                            encoder->parameter.f -= encoder->step.f;
-                            break;
-                    }
-                    // printf("[ENCODER DEBUG] NEW LOWER PARAMETER VALUE. Param=%d", encoder->parameter.int_val);
-                }
-            }
+            int64_t elapsed_us = now_us - encoder->idle_exit_us;
+            uint32_t delay_us = (elapsed_us > (int64_t)UINT32_MAX) ? UINT32_MAX : (uint32_t)elapsed_us;
 
-            // Same logic for the parameter increase with the clockwise rotation
-            else if (side == COUNTERCLOCKWISE)
-            {
-                if (dt_state != clk_state)
-                {
-                    // Switch with low-side limits
-                    switch (encoder->controlled_parameter_type)
-                    {
-                        case TYPE_UNS_INT:
-                            if (rotation_regime == LIMITATION)
-                            {
-                                if (encoder->parameter.uns_int <= encoder->step.uns_int)
-                                    encoder->parameter.uns_int = encoder->min_val.uns_int;
-                                else
-                                    encoder->parameter.uns_int -= encoder->step.uns_int;
-                            }
-                            else
-                            {
-                                encoder->parameter.uns_int -= encoder->step.uns_int;
-                            }
-                            break;
-                    
-                        case TYPE_INT:
-                            encoder->parameter.int_val -= encoder->step.int_val;
-                            break;
-                    
-                        case TYPE_UINT_8:
-                            if (rotation_regime == LIMITATION)
-                            {
-                                if (encoder->parameter.u8 <= encoder->step.u8)
-                                    encoder->parameter.u8 = encoder->min_val.u8;
-                                else
-                                    encoder->parameter.u8 -= encoder->step.u8;
-                            }
-                            else
-                            {
-                                encoder->parameter.u8 -= encoder->step.u8;
-                            }
-                            break;
-                    
-                        case TYPE_UINT_16:
-                            if (rotation_regime == LIMITATION)
-                            {
-                                if (encoder->parameter.u16 <= encoder->step.u16)
-                                    encoder->parameter.u16 = encoder->min_val.u16;
-                                else
-                                    encoder->parameter.u16 -= encoder->step.u16;
-                            }
-                            else
-                            {
-                                encoder->parameter.u16 -= encoder->step.u16;
-                            }
-                            break;
-                    
-                        case TYPE_UINT_32:
-                            if (rotation_regime == LIMITATION)
-                            {
-                                if (encoder->parameter.u32 <= encoder->step.u32)
-                                    encoder->parameter.u32 = encoder->min_val.u32;
-                                else
-                                    encoder->parameter.u32 -= encoder->step.u32;
-                            }
-                            else
-                            {
-                                encoder->parameter.u32 -= encoder->step.u32;
-                            }
-                            break;
-                    
-                        case TYPE_UINT_64:
-                            if (rotation_regime == LIMITATION)
-                            {
-                                if (encoder->parameter.u64 <= encoder->step.u64)
-                                    encoder->parameter.u64 = encoder->min_val.u64;
-                                else
-                                    encoder->parameter.u64 -= encoder->step.u64;
-                            }
-                            else
-                            {
-                                encoder->parameter.u64 -= encoder->step.u64;
-                            }
-                            break;
-                    
-                        case TYPE_FLOAT:
-                            encoder->parameter.f -= encoder->step.f;
-                            break;
-                    }
-                }
-                else
-                {
-                    switch (encoder->controlled_parameter_type)
-                    {
-                        case TYPE_UNS_INT: encoder->parameter.uns_int += encoder->step.uns_int; break;
-                        case TYPE_INT: encoder->parameter.int_val += encoder->step.int_val; break;
-                        case TYPE_UINT_8: encoder->parameter.u8 += encoder->step.u8; break;
-                        case TYPE_UINT_16: encoder->parameter.u16 += encoder->step.u16; break;
-                        case TYPE_UINT_32: encoder->parameter.u32 += encoder->step.u32; break;
-                        case TYPE_UINT_64: encoder->parameter.u64 += encoder->step.u64; break;
-                        case TYPE_FLOAT: encoder->parameter.f += encoder->step.f; break;
-                    }
-                }
-            }
+            encoder->power_stats.last_exit_poll_delay_us = delay_us;
+            if (delay_us > encoder->power_stats.max_exit_poll_delay_us) encoder->power_stats.max_exit_poll_delay_us = delay_us;
         }
-    
 
-        // Limitations setup 
-        // If we choose to obtain the current limit value with limit overflow
-        if (rotation_regime == LIMITATION)
-        {
-            switch (encoder->controlled_parameter_type)
-            {
-                // Limitation by the current parameter value compare with selected limits for selected data type
-                case TYPE_UNS_INT:
-                    if ((int)encoder->parameter.uns_int < (int)encoder->min_val.uns_int)
-                        encoder->parameter.uns_int = encoder->min_val.uns_int;
-
-                    if ((int)encoder->parameter.uns_int > (int)encoder->max_val.uns_int)
-                        encoder->parameter.uns_int = encoder->max_val.uns_int;
-                    break;
-        
-                case TYPE_INT:
-                    if (encoder->parameter.int_val < encoder->min_val.int_val)
-                        encoder->parameter.int_val = encoder->min_val.int_val;
-                    if (encoder->parameter.int_val > encoder->max_val.int_val)
-                        encoder->parameter.int_val = encoder->max_val.int_val;
-                    break;
-    
-                case TYPE_UINT_8:
-                    if ((int)encoder->parameter.u8 < (int)encoder->min_val.u8)
-                        encoder->parameter.u8 = encoder->min_val.u8;
+        encoder->exit_poll_pending = false;
+    }
 
-                    if ((int)encoder->parameter.u8 > (int)encoder->max_val.u8)
-                        encoder->parameter.u8 = encoder->max_val.u8;
-                    break;
+    // No input changes
+    if (!changed) return;
 
-                case TYPE_UINT_16:
-                    if ((long)encoder->parameter.u16 < (long)encoder->min_val.u16)
-                        encoder->parameter.u16 = encoder->min_val.u16;
+    encoder->last_input = *input;
+    encoder->last_activity_us = now_us;
+}
 
-                    if ((long)encoder->parameter.u16 > (long)encoder->max_val.u16)
-                        encoder->parameter.u16 = encoder->max_val.u16;
-                    break;
-        
-                case TYPE_UINT_32:
-                    if ((long long)encoder->parameter.u32 < (long long)encoder->min_val.u32)
-                        encoder->parameter.u32 = encoder->min_val.u32;
 
-                    if ((long long)encoder->parameter.u32 > (long long)encoder->max_val.u32)
-                        encoder->parameter.u32 = encoder->max_val.u32;
-                    break;
-        
-                case TYPE_UINT_64:
-                    if ((double)encoder->parameter.u64 < (double)encoder->min_val.u64)
-                        encoder->parameter.u64 = encoder->min_val.u64;
+// Adaptive poll interval update after the decoding: the quarter step velocity of the decoder (one estimate for the
+// recovery and the polling), the fast polling for the rotation and the SW-button debounce, back off without the steps
+static void enc_poll_update(encoder_ctx *encoder, const encoder_input_snapshot *input, int64_t now_us)
+{
+    const encoder_poll_config *config = &encoder->poll_config;
+    uint32_t interval_us = encoder->poll_interval_us;
 
-                    if ((double)encoder->parameter.u64 > (double)encoder->max_val.u64)
-                        encoder->parameter.u64 = encoder->max_val.u64;
-                    break;
-        
-                case TYPE_FLOAT:
-                    if (encoder->parameter.f < encoder->min_val.f)
-                        encoder->parameter.f = encoder->min_val.f;
-                    if (encoder->parameter.f > encoder->max_val.f)
-                        encoder->parameter.f = encoder->max_val.f;
-                    break;
-            }
-        }
+    // Rotation stop time: no steps for the hold phases of the average phase (or the maximal interval before the first average)
+    uint32_t hold_us = encoder->step_interval_us ? encoder->step_interval_us * ENC_POLL_HOLD_PHASES : config->max_interval_us;
 
-        // If we choose to obtain the other limit value with limit overflow        
-        else if (rotation_regime == ROTATION)
-        {
-            switch (encoder->controlled_parameter_type)
-            {
-                // Value change to other limit by the current parameter value compare with selected limits for selected data type
-                case TYPE_UNS_INT:
-                    if ((int)encoder->parameter.uns_int < (int)encoder->min_val.uns_int)
-                        encoder->parameter.uns_int = encoder->max_val.uns_int;
-                    if ((int)encoder->parameter.uns_int > (int)encoder->max_val.uns_int)
-                        encoder->parameter.uns_int = encoder->min_val.uns_int;
-                    break;
-        
-                case TYPE_INT:
-                    if (encoder->parameter.int_val < encoder->min_val.int_val)
-                        encoder->parameter.int_val = encoder->max_val.int_val;
-                    if (encoder->parameter.int_val > encoder->max_val.int_val)
-                        encoder->parameter.int_val = encoder->min_val.int_val;
-                    break;
-        
-                case TYPE_UINT_8:
-                    if ((int)encoder->parameter.u8 < (int)encoder->min_val.u8)
-                        encoder->parameter.u8 = encoder->max_val.u8;
-                    if ((int)encoder->parameter.u8 > (int)encoder->max_val.u8)
-                        encoder->parameter.u8 = encoder->min_val.u8;
-                    break;
-
-                case TYPE_UINT_16:
-                    if ((int)encoder->parameter.u16 < (int)encoder->min_val.u16)
-                        encoder->parameter.u16 = encoder->max_val.u16;
-                    if ((int)encoder->parameter.u16 > (int)encoder->max_val.u16)
-                        encoder->parameter.u16 = encoder->min_val.u16;
-                    break;
-        
-                case TYPE_UINT_32:
-                    if ((long long)encoder->parameter.u32 < (long long)encoder->min_val.u32)
-                        encoder->parameter.u32 = encoder->max_val.u32;
-                    if ((long long)encoder->parameter.u32 > (long long)encoder->max_val.u32)
-                        encoder->parameter.u32 = encoder->min_val.u32;
-                    break;
-        
-                case TYPE_UINT_64:
-                    if ((double)encoder->parameter.u64 < (double)encoder->min_val.u64)
-                        encoder->parameter.u64 = encoder->max_val.u64;
-                    if ((double)encoder->parameter.u64 > (double)encoder->max_val.u64)
-                        encoder->parameter.u64 = encoder->min_val.u64;
-                    break;
-        
-                case TYPE_FLOAT:
-                    if (encoder->parameter.f < encoder->min_val.f)
-                        encoder->parameter.f = encoder->max_val.f;
-                    if (encoder->parameter.f > encoder->max_val.f)
-                        encoder->parameter.f = encoder->min_val.f;
-                    break;
-            }
-        }
+    // Quarter step on this control call
+    if (encoder->last_step_us == now_us)
+    {
+        // The shortest of the last and the average intervals - fast reaction for the acceleration
+        uint32_t phase_us = (encoder->last_interval_us < encoder->step_interval_us) ? encoder->last_interval_us : encoder->step_interval_us;
 
-        // Update the parameter value by the link with dependence from selected data type 
-        switch (type) {
-            case TYPE_UNS_INT: *(unsigned int*)parameter = encoder->parameter.uns_int; break;
-            case TYPE_INT:     *(int*)parameter = encoder->parameter.int_val; break;
-            case TYPE_UINT_8: *(uint8_t*)parameter = encoder->parameter.u8; break;
-            case TYPE_UINT_16: *(uint16_t*)parameter = encoder->parameter.u16; break;
-            case TYPE_UINT_32: *(uint32_t*)parameter = encoder->parameter.u32; break;
-            case TYPE_UINT_64: *(uint64_t*)parameter = encoder->parameter.u64; break;
-            case TYPE_FLOAT:   *(float*)parameter = encoder->parameter.f; break;
-        }
+        // Rotation start after the stop, the pause or the reversal - no velocity yet, the fastest polling
+        interval_us = phase_us ? phase_us / config->phase_samples : config->min_interval_us;
+    }
+    else
+    {
+        // Rotation stop - exponential back off
+        if (now_us - encoder->last_step_us > (int64_t)hold_us) interval_us *= 2;
     }
-    // Switch the encoder clk state to the last state value
-    encoder->last_clk_state = clk_state;
 
-    // ENCODER CONTROL LOOP END
+    // SW-button change inside the debounce time
+    if (encoder->gestures_enabled && input->sw != encoder->sw_pressed)
+    {
+        uint32_t sw_interval_us = encoder->gesture_config.sw_debounce_us / 2;
+        if (interval_us > sw_interval_us) interval_us = sw_interval_us;
+    }
+
+    // Limits
+    if (interval_us < config->min_interval_us) interval_us = config->min_interval_us;
+    if (interval_us > config->max_interval_us) interval_us = config->max_interval_us;
+
+    encoder->poll_interval_us = interval_us;
+    encoder->next_poll_us = now_us + interval_us;
+}
+
+
+// Pin wakeup arm by the level, opposite to the last decoded level - any change (or the change, missed by the
+// last control call) wakes the controller up
+static inline void enc_pin_wakeup_arm(gpio_num_t pin, bool level)
+{
+    if (pin == GPIO_PIN_NONE) return;
+
+    gpio_wakeup_enable(pin, level ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL);
+}
+
+
+// Rotation debounce: shared time base for the gesture engine, async_await for the ordinary workflow
+static bool enc_rotation_debounce(encoder_ctx *encoder, int64_t now_us)
+{
+    if (!encoder->gestures_enabled) return async_await(&encoder->ENC_AWAIT, ENC_CLK_EDGE_DEBOUNCE_MS, TIME_UNIT_MS, false);
+
+    if (now_us - encoder->last_detent_us < (int64_t)encoder->gesture_config.rotation_debounce_us) return false;
+
+    encoder->last_detent_us = now_us;
+
+    return true;
+}
+
+
+// SW-button click recognition result: the table entry switch (if enabled) and the event
+static void enc_sw_click_recognized(encoder_ctx *encoder)
+{
+    if (encoder->sw_table_switch && encoder->parameter_table) encoder_parameter_next(encoder);
+
+    enc_event_push(encoder, ENC_EVENT_SW_CLICK, 1);
+}
+
+
+// Pending single click report before the other gesture of the next press (long press, press-and-turn),
+// which can't be the second click of the double click anymore
+static void enc_sw_click_flush(encoder_ctx *encoder)
+{
+    if (encoder->sw_clicks != 1) return;
+
+    encoder->sw_clicks = 0;
+    enc_sw_click_recognized(encoder);
+}
+
+
+// SW-button gestures recognition (click, double click, long press) by the input snapshot with the debounce
+static void enc_gesture_process(encoder_ctx *encoder, const encoder_input_snapshot *input, int64_t now_us)
+{
+    const encoder_gesture_config *config = &encoder->gesture_config;
+
+    // Raw state change fix for the debounce
+    if (input->sw != encoder->sw_raw_state)
+    {
+        encoder->sw_raw_state = input->sw;
+        encoder->sw_raw_change_us = now_us;
+    }
+
+    // Debounced state change
+    if (encoder->sw_raw_state != encoder->sw_pressed && now_us - encoder->sw_raw_change_us >= (int64_t)config->sw_debounce_us)
+    {
+        encoder->sw_pressed = encoder->sw_raw_state;
+
+        // Press start
+        if (encoder->sw_pressed)
+        {
+            encoder->sw_press_us = now_us;
+            encoder->sw_long_sent = false;
+            encoder->sw_turned = false;
+        }
+        // Release - click only after the short press without the rotation
+        else if (!encoder->sw_long_sent && !encoder->sw_turned)
+        {
+            encoder->sw_release_us = now_us;
+
+            // Second click inside the double click window
+            if (++encoder->sw_clicks >= 2)
+            {
+                encoder->sw_clicks = 0;
+                enc_event_push(encoder, ENC_EVENT_SW_DOUBLE_CLICK, 1);
+            }
+        }
+        else
+        {
+            encoder->sw_clicks = 0;
+        }
+    }
+
+    // Long press by the hold time
+    if (encoder->sw_pressed && !encoder->sw_long_sent && !encoder->sw_turned &&
+        now_us - encoder->sw_press_us >= (int64_t)config->long_press_us) {
+
+        encoder->sw_long_sent = true;
+        enc_sw_click_flush(encoder);
+        enc_event_push(encoder, ENC_EVENT_SW_LONG_PRESS, 1);
+    }
+
+    // Single click after the double click window expiration
+    if (!encoder->sw_pressed && now_us - encoder->sw_release_us >= (int64_t)config->double_click_us) enc_sw_click_flush(encoder);
+}
+
+
+// One-time SW-button press read by the button_control library
+static bool enc_sw_click_read(encoder_ctx *encoder)
+{
+    bool sw_pressed = false;
+
+    // Scanned encoder SW is not a GPIO pin - the gesture engine only
+    if (encoder->ENC_SW != GPIO_PIN_NONE && !encoder->scan_bus)
+        flag_control_by_but_onetime_press(&encoder->sw_button, &sw_pressed);
+
+    return sw_pressed;
+}
+
+
+// Rotation events generation after the accepted detent
+// direction: +1 for the parameter increase, -1 for the parameter decrease
+static void enc_rotation_events_push(encoder_ctx *encoder, const encoder_parameter *par, int8_t direction,
+    bool changed, bool wrapped) {
+
+    // Value change event only for the real value change (not for the value, saved by the limitation)
+    if (changed) enc_event_push(encoder, ENC_EVENT_VALUE_CHANGED, direction);
+
+    // Overflow mode events
+    if (par->overflow_mode == LIMITATION)
+    {
+        bool at_limit;
+
+        // Index rests on the table end in the rotation direction for the index mapping
+        if (par->lut)
+        {
+            at_limit = par->lut_index == ((direction > 0) ? par->lut_size - 1 : 0);
+        }
+        // Value rests on the limit in the rotation direction
+        else
+        {
+            const parameter_value_union *limit = (direction > 0) ? &par->max_val : &par->min_val;
+
+            at_limit = par_value_compare(par->type, &par->parameter, limit) == 0;
+        }
+
+        if (at_limit) enc_event_push(encoder, ENC_EVENT_LIMIT_HIT, direction);
+    }
+    else if (par->overflow_mode == ROTATION && wrapped)
+    {
+        enc_event_push(encoder, ENC_EVENT_WRAPPED, direction);
+    }
+}
+
+
+// CLK rising edge decoding: detent direction by the DT state at the CLK rising (with the debounce)
+static int8_t enc_clk_edge_decode(encoder_ctx *encoder, const encoder_input_snapshot *input, int64_t now_us)
+{
+    // Get the encoder clk pin state
+    int clk_state = input->clk;
+    int8_t rotation = 0;
+
+    // Compare current clk state with the last clk state value, and if it's changed
+    if (clk_state != encoder->last_clk_state && clk_state == 1)
+    {
+        // If the code pass through the debounce - direction by the dt pin state from the same snapshot
+        if (enc_rotation_debounce(encoder, now_us)) rotation = (input->dt != clk_state) ? 1 : -1;
+    }
+
+    // Switch the encoder clk state to the last state value
+    encoder->last_clk_state = clk_state;
+
+    return rotation;
+}
+
+
+// Quadrature state position inside the positive sequence (CLK, DT): 00 -> 10 -> 11 -> 01 -> 00
+// (CLK rises with DT = 0 - the same positive direction as for the CLK edge decoder)
+static const uint8_t quadrature_phase[4] = {
+    0,  // 00
+    3,  // 01
+    1,  // 10
+    2,  // 11
+};
+
+
+// Quarter steps accumulation: one detent per full quadrature period
+static int8_t enc_quadrature_accumulate(encoder_ctx *encoder, int8_t quarter_steps)
+{
+    encoder->quad_steps += quarter_steps;
+
+    if (encoder->quad_steps >= 4)
+    {
+        encoder->quad_steps -= 4;
+        return 1;
+    }
+
+    if (encoder->quad_steps <= -4)
+    {
+        encoder->quad_steps += 4;
+        return -1;
+    }
+
+    return 0;
+}
+
+
+// Quarter step velocity: the average interval by the passed states - from the second step of the same direction after
+// the sync, the pause or the reversal (a single step from the pins can be the aliased skip of three states).
+// One estimate for the skipped states recovery and the adaptive polling
+static void enc_velocity_update(encoder_ctx *encoder, int8_t direction, uint8_t states, uint32_t since_step_us, int64_t now_us)
+{
+    if (direction != 0 && direction == encoder->last_step_direction)
+    {
+        encoder->last_interval_us = since_step_us / states;
+        encoder->step_interval_us = (encoder->step_interval_us == 0) ? encoder->last_interval_us :
+                                    (encoder->step_interval_us * 3 + encoder->last_interval_us) / 4;
+    }
+    else
+    {
+        encoder->last_interval_us = 0;
+        encoder->step_interval_us = 0;
+    }
+
+    encoder->last_step_direction = direction;
+    encoder->last_step_us = now_us;
+}
+
+
+// Full (CLK, DT) state machine: quarter steps since the last snapshot (0 - no change or the dropped skipped state)
+// with the velocity update. Runs for all the decoders (the velocity for the adaptive polling), the recovery is used
+// by the recovery decoder only: the state jump by two positions and the reverse step of the continuous rotation
+// (three positions) after the late polls are recovered by the recent direction and velocity
+static int8_t enc_quarter_steps_decode(encoder_ctx *encoder, const encoder_input_snapshot *input, int64_t now_us)
+{
+    uint8_t state = (uint8_t)((input->clk << 1) | input->dt);
+    uint8_t shift = (quadrature_phase[state] - quadrature_phase[encoder->quad_state]) & 0x3;
+
+    encoder->quad_state = state;
+
+    // No state change
+    if (shift == 0)
+    {
+        if (encoder->idle_polls < UINT8_MAX) encoder->idle_polls++;
+        return 0;
+    }
+
+    // Time from the last quarter step (clamped - no wrap after the long idle)
+    int64_t elapsed_us = now_us - encoder->last_step_us;
+    uint32_t since_step_us = (elapsed_us > (int64_t)UINT32_MAX) ? UINT32_MAX : (elapsed_us < 0) ? 0 : (uint32_t)elapsed_us;
+
+    // Pause after the last step: the direction and the velocity are outdated - the estimate restarts from this step.
+    // The pause by the average intervals takes the same number of the control calls without the state change at least
+    // (a single unchanged poll of the fast rotation can be the whole quadrature period between two polls)
+    if (since_step_us > ENC_RECOVERY_MAX_INTERVAL_US ||
+        (encoder->step_interval_us != 0 && since_step_us > encoder->step_interval_us * ENC_RECOVERY_INTERVALS &&
+         encoder->idle_polls >= ENC_RECOVERY_INTERVALS))
+    {
+        encoder->step_interval_us = 0;
+        encoder->last_interval_us = 0;
+        encoder->last_step_direction = 0;
+    }
+
+    // Control calls without the state change before this step (0 - the continuous rotation)
+    uint8_t idle_polls = encoder->idle_polls;
+    encoder->idle_polls = 0;
+
+    int8_t quarter_steps;
+
+    // Recovery by the recent direction and velocity: the rotation is still going with the known quarter step interval
+    bool recovery = encoder->decoder_mode == ENC_DECODER_QUADRATURE_RECOVERY &&
+                    encoder->last_step_direction != 0 && encoder->step_interval_us != 0;
+
+    // Valid transition to the neighbour state
+    if (shift != 2)
+    {
+        quarter_steps = (shift == 1) ? 1 : -1;
+
+        // Step against the recent direction during the rotation: three skipped states or the reversal
+        if (recovery && quarter_steps != encoder->last_step_direction)
+        {
+            // Continuous rotation after one average interval or more: three states of the same rotation have passed
+            // between the polls
+            if (idle_polls == 0 && since_step_us >= encoder->step_interval_us)
+            {
+                quarter_steps = (int8_t)(3 * encoder->last_step_direction);
+                encoder->recovered_steps++;
+            }
+            // The reversal: the unchanged polls with the step time near the recent interval, or ENC_RECOVERY_INTERVALS
+            // unchanged polls. Otherwise the step is ambiguous (the aliased skip of more states between the polls):
+            // it is taken from the pins, the recent direction and velocity are kept
+            else if (idle_polls == 0 || (idle_polls < ENC_RECOVERY_INTERVALS && since_step_us >= encoder->step_interval_us * 2))
+            {
+                encoder->last_step_us = now_us;
+                encoder->ambiguous_steps++;
+
+                return quarter_steps;
+            }
+        }
+    }
+    // Skipped state - the direction can't be taken from the pins
+    else
+    {
+        // Dropped - the velocity still takes two states in the recent direction
+        if (!recovery)
+        {
+            enc_velocity_update(encoder, encoder->last_step_direction, 2, since_step_us, now_us);
+            encoder->ambiguous_steps++;
+
+            return 0;
+        }
+
+        quarter_steps = (int8_t)(2 * encoder->last_step_direction);
+        encoder->recovered_steps++;
+    }
+
+    enc_velocity_update(encoder, (quarter_steps > 0) ? 1 : -1, (uint8_t)((quarter_steps > 0) ? quarter_steps : -quarter_steps),
+                        since_step_us, now_us);
+
+    return quarter_steps;
+}
+
+
+// Full (CLK, DT) state machine decoding: quarter steps accumulation with one detent per 4 quarter steps.
+// Contact bounce moves the state back and forth and compensates itself, so no debounce is required
+static int8_t enc_quadrature_decode(encoder_ctx *encoder, const encoder_input_snapshot *input, int64_t now_us)
+{
+    encoder->last_clk_state = input->clk;
+
+    return enc_quadrature_accumulate(encoder, enc_quarter_steps_decode(encoder, input, now_us));
+}
+
+
+// Decoder states sync with the last input snapshot
+static void enc_decoder_sync(encoder_ctx *encoder)
+{
+    encoder->last_clk_state = encoder->last_input.clk;
+    encoder->quad_state = (uint8_t)((encoder->last_input.clk << 1) | encoder->last_input.dt);
+    encoder->quad_steps = 0;
+    encoder->last_step_direction = 0;
+    encoder->step_interval_us = 0;
+    encoder->last_interval_us = 0;
+    encoder->idle_polls = 0;
+}
+
+// =========================================================================================== HELPER FUNCTIONS
+
+
+// =========================================================================================== API DEFINITION SECTION
+
+// Creates and initializes an encoder context
+void encoder_initialization(encoder_ctx *encoder,
+    gpio_num_t vcc_pin,
+    gpio_num_t gnd_pin,
+    gpio_num_t sw_pin,
+    gpio_num_t dt_pin,
+    gpio_num_t clk_pin) {
+
+    // Error handler
+    if (!encoder) return;
+
+    // Default context values with initialization by the function
+    *encoder = encoder_ctx_default();
+    
+    // Pins adding into context
+    encoder->ENC_VCC = vcc_pin;
+    encoder->ENC_GND = gnd_pin;
+    encoder->ENC_SW = sw_pin;
+    encoder->ENC_DT = dt_pin;
+    encoder->ENC_CLK = clk_pin;
+
+    // Debounce await for the rotation
+    encoder->ENC_AWAIT = async_await_ctx_default();
+
+    // Pins setup, depending on the values passed as function arguments
+    // Encoder VCC initialization
+    if (encoder->ENC_VCC != GPIO_PIN_NONE)
+    {
+        gpio_set_direction(encoder->ENC_VCC, GPIO_MODE_OUTPUT);
+        gpio_set_level(encoder->ENC_VCC, 1);
+    }
+
+    // Encoder GND initialization
+    if (encoder->ENC_GND != GPIO_PIN_NONE)
+    {
+        gpio_set_direction(encoder->ENC_GND, GPIO_MODE_OUTPUT);
+        gpio_set_level(encoder->ENC_GND, 0);
+    }
+
+    // Encoder SW initialization
+    if (encoder->ENC_SW != GPIO_PIN_NONE)
+    {
+        encoder->sw_button = button_initialization(encoder->ENC_SW, GPIO_PULLUP_ONLY, NO_FIX);
+    }
+
+    // Encoder DT initialization
+    if (encoder->ENC_DT != GPIO_PIN_NONE)
+    {
+        gpio_set_direction(encoder->ENC_DT, GPIO_MODE_INPUT);
+        gpio_set_pull_mode(encoder->ENC_DT, GPIO_PULLUP_ONLY);
+    }
+
+    // Encoder CLK initialization
+    if (encoder->ENC_CLK != GPIO_PIN_NONE)
+    {
+        gpio_set_direction(encoder->ENC_CLK, GPIO_MODE_INPUT);
+        gpio_set_pull_mode(encoder->ENC_CLK, GPIO_PULLUP_ONLY);
+
+
+        // Initial CLK state for the enc_rotation_value_control function
+        encoder->last_clk_state = fast_gpio_read(encoder->ENC_CLK);
+    }
+
+    // Error handler
+    else encoder->last_clk_state = 0;
+
+    // Initial input snapshot and time for the idle mode and the power accounting
+    enc_input_read(encoder, &encoder->last_input);
+    enc_decoder_sync(encoder);
+
+    encoder->last_activity_us = enc_time_now_us();
+    encoder->power_stats_start_us = encoder->last_activity_us;
+}
+
+
+// Any type stepped parameter value control by the encoder rotation with the different side logic and different limitation logic
+void enc_rotation_value_control(encoder_ctx *encoder,
+    rotation_side side,
+    rotation_overflow_mode rotation_regime,
+    void *parameter,
+    parameter_type type,
+    void *step,
+    void *min_val,
+    void *max_val) {
+    
+    // Error handler
+    if (encoder->ENC_CLK == GPIO_PIN_NONE || encoder->ENC_DT == GPIO_PIN_NONE) return;
+
+    // Direct call parameter storage
+    encoder_parameter *par = &encoder->direct_parameter;
+    
+    // Type error handler with the type setup
+    if (par->type != type) encoder->new_parameter_type = true;
+    
+    // Reset the values, regulated by encoder with type change
+    if (encoder->new_parameter_type)
+    {
+        // Set the new type inside the encoder context
+        par->type = type;
+
+        // Data converting by new the selected type with saving inside the storage 
+        par_type_converting(encoder, type, parameter, step, min_val, max_val);
+
+        // Operation control flag change
+        encoder->new_parameter_type = false;
+    }
+
+    // Regulation parameters switch logic with type error handler
+    if (par->type == type && regulation_values_changed(encoder, type, parameter, step, min_val, max_val))
+    {
+        // Reset the parameters values with the additional type error processing
+        par_type_converting(encoder, type, parameter, step, min_val, max_val);
+    }   
+
+    // Rotation settings of the current call
+    par->link = parameter;
+    par->side = side;
+    par->overflow_mode = rotation_regime;
+
+    encoder->active_parameter = par;
+
+    enc_parameter_rotation_control(encoder, par);
+}
+
+
+// Index crossing direction update by the quarter step between the snapshots (the skipped state keeps the last direction)
+static inline void enc_index_direction_update(encoder_ctx *encoder, const encoder_input_snapshot *input)
+{
+    uint8_t state = (uint8_t)((input->clk << 1) | input->dt);
+    uint8_t last_state = (uint8_t)((encoder->last_input.clk << 1) | encoder->last_input.dt);
+    uint8_t shift = (quadrature_phase[state] - quadrature_phase[last_state]) & 0x3;
+
+    if (shift == 1) encoder->index_direction = 1;
+    else if (shift == 3) encoder->index_direction = -1;
+}
+
+
+// Index pulse processing: homing or the counts per revolution check with the drift correction.
+// The Z window and the count edges give the position, which differs by one count for the opposite crossing directions,
+// so the pulse is checked against the reference of the same direction only
+static void enc_index_process(encoder_ctx *encoder)
+{
+    encoder->index_pulses++;
+
+    int8_t direction = encoder->index_direction;
+    uint8_t side = (direction > 0) ? 0 : 1;
+
+    // Homing: position reference by the first index pulse (the other direction reference is taken by its first pulse)
+    if (encoder->homing_state == ENC_HOMING_SEEK)
+    {
+        encoder->position = encoder->home_position;
+        encoder->index_latched[0] = false;
+        encoder->index_latched[1] = false;
+
+        if (direction != 0)
+        {
+            encoder->index_position[side] = encoder->position;
+            encoder->index_latched[side] = true;
+        }
+
+        encoder->homing_state = ENC_HOMING_DONE;
+
+        enc_event_push(encoder, ENC_EVENT_HOMED, 0);
+        return;
+    }
+
+    // Error handler - unknown crossing direction (no quarter steps since the setup)
+    if (direction == 0) return;
+
+    // Counts per revolution check from the last index pulse of the same direction (the travel should be the whole revolutions number)
+    if (encoder->index_latched[side] && encoder->counts_per_rev != 0)
+    {
+        int32_t cpr = (int32_t)encoder->counts_per_rev;
+        int32_t travel = encoder->position - encoder->index_position[side];
+
+        // Nearest whole revolutions number with the sign
+        int32_t revolutions = (travel >= 0) ? (travel + cpr / 2) / cpr : -((-travel + cpr / 2) / cpr);
+        int32_t drift = travel - revolutions * cpr;
+
+        if (drift != 0)
+        {
+            encoder->last_drift = drift;
+            encoder->drift_events++;
+
+            // Drift correction - the position returns to the index reference
+            if (encoder->index_correction)
+            {
+                encoder->position -= drift;
+                encoder->drift_corrected += (drift > 0) ? (uint32_t)drift : (uint32_t)-drift;
+            }
+
+            enc_event_push(encoder, ENC_EVENT_INDEX_DRIFT, drift);
+
+            // Other direction reference has been taken with the unknown part of the drift - it is taken again by its next pulse
+            encoder->index_latched[side ^ 1] = false;
+        }
+    }
+
+    // Index reference latch
+    encoder->index_position[side] = encoder->position;
+    encoder->index_latched[side] = true;
+}
+
+
+// Encoder input processing by one snapshot: activity, SW gestures, detent decoding and the index channel
+// Returns the detent direction by the pins (+1 - DT differs from CLK at the CLK rising, -1 - equal, 0 - no detent)
+static int8_t enc_input_control(encoder_ctx *encoder)
+{
+    // One input snapshot (SW, CLK, DT, Z) and one time base for the rotation and the SW gestures
+    encoder_input_snapshot input;
+    enc_input_read(encoder, &input);
+
+    int64_t now_us = enc_time_now_us();
+
+    // Index pulse rising edge and the crossing direction (compared with the previous snapshot before the activity update)
+    bool index_edge = false;
+
+    if (encoder->ENC_Z != GPIO_PIN_NONE)
+    {
+        enc_index_direction_update(encoder, &input);
+        index_edge = input.z && !encoder->last_input.z;
+    }
+
+    // Input activity fix for the idle mode and the power accounting
+    enc_activity_update(encoder, &input, now_us);
+
+    // SW gestures recognition
+    if (encoder->gestures_enabled) enc_gesture_process(encoder, &input, now_us);
+
+    // Detent decoding by the selected decoder (the quarter steps velocity for the CLK edge decoder too)
+    int8_t rotation;
+
+    if (encoder->decoder_mode == ENC_DECODER_CLK_EDGE)
+    {
+        rotation = enc_clk_edge_decode(encoder, &input, now_us);
+        enc_quarter_steps_decode(encoder, &input, now_us);
+    }
+    else rotation = enc_quadrature_decode(encoder, &input, now_us);
+
+    // Adaptive poll interval by the decoder velocity
+    if (encoder->poll_enabled) enc_poll_update(encoder, &input, now_us);
+
+    // Press-and-turn for both control paths: the pending click is reported, the click and the long press
+    // of the current SW-button hold are cancelled
+    if (rotation != 0 && encoder->gestures_enabled && encoder->sw_pressed)
+    {
+        enc_sw_click_flush(encoder);
+        encoder->sw_turned = true;
+        enc_event_push(encoder, ENC_EVENT_PRESS_TURN, rotation);
+    }
+
+    // Absolute position by the detents
+    int32_t last_position = encoder->position;
+    encoder->position += rotation;
+
+    // Index channel after the position update
+    if (index_edge) enc_index_process(encoder);
+
+    // Position history record (rotation or the index correction)
+    if (encoder->history && encoder->position != last_position)
+        encoder_history_append(encoder->history, now_us, encoder->position);
+
+    return rotation;
+}
+
+
+// Cached parameter value control by the encoder rotation with the parameter own side and limitation logic
+void enc_parameter_rotation_control(encoder_ctx *encoder, encoder_parameter *par) {
+
+    // Error handler
+    if (!encoder || !par || !par->link) return;
+    if (encoder->ENC_CLK == GPIO_PIN_NONE || encoder->ENC_DT == GPIO_PIN_NONE) return;
+
+    // External change of the controlled variable - only the parameter value reload, without the full converting
+    // (the table index is the value holder for the index mapping)
+    if (!par->lut && par_link_changed(par)) par_link_load(par);
+
+    // Events and dirty bits source
+    encoder->active_parameter = par;
+
+
+    // ENCODER CONTROL LOOP START
+
+    // Input processing with the detent decoding (+1 - DT differs from CLK at the CLK rising, -1 - equal)
+    int8_t rotation = enc_input_control(encoder);
+
+    if (rotation == 0) return;
+
+    // Table entry switch by the pending click, reported at the press-and-turn
+    if (encoder->active_parameter != par)
+    {
+        // Table entry control - the detent goes to the new active entry
+        if (enc_parameter_index(encoder, par) != ENC_PARAMETER_DIRECT)
+        {
+            par = encoder->active_parameter;
+
+            // Error handler
+            if (!par->link) return;
+
+            if (!par->lut && par_link_changed(par)) par_link_load(par);
+        }
+        // Other parameter control - the parameter stays the events source
+        else
+        {
+            encoder->active_parameter = par;
+        }
+    }
+
+    // Parameter value before the detent and the detent direction (+1 increase, -1 decrease) by the rotation side
+    parameter_value_union previous_value = par->parameter;
+    int8_t detent_direction = (par->side == CLOCKWISE) ? rotation : -rotation;
+    bool wrapped = false;
+
+    // Press-and-turn gesture - coarse step by the SW-button hold
+    bool press_turn = encoder->gestures_enabled && encoder->sw_pressed;
+    uint16_t step_multiplier = press_turn ? encoder->gesture_config.coarse_multiplier : 1;
+
+    // Regulation step of the current detent
+    parameter_value_union step = press_turn ? par_step_scale(par->type, &par->step, step_multiplier) : par->step;
+
+    // Index mapping: index step with the table value load
+    if (par->lut)
+    {
+        wrapped = enc_lut_index_step(par, detent_direction, step_multiplier);
+    }
+
+    // Parameter increase
+    else if (detent_direction > 0)
+    {
+        // Summarize the step value and current parameter value by the current type
+        // Unsigned types saturate at the type maximum - the value above max_val is limited or rotated below,
+        // instead of the wrap to the small value inside the limits
+        switch (par->type)
+        {
+            case TYPE_UNS_INT:
+                if (step.uns_int > UINT_MAX - par->parameter.uns_int) par->parameter.uns_int = UINT_MAX;
+                else par->parameter.uns_int += step.uns_int;
+                break;
+
+            case TYPE_INT: par->parameter.int_val += step.int_val; break;
+
+            case TYPE_UINT_8:
+                if (step.u8 > UINT8_MAX - par->parameter.u8) par->parameter.u8 = UINT8_MAX;
+                else par->parameter.u8 += step.u8;
+                break;
+
+            case TYPE_UINT_16:
+                if (step.u16 > UINT16_MAX - par->parameter.u16) par->parameter.u16 = UINT16_MAX;
+                else par->parameter.u16 += step.u16;
+                break;
+
+            case TYPE_UINT_32:
+                if (step.u32 > UINT32_MAX - par->parameter.u32) par->parameter.u32 = UINT32_MAX;
+                else par->parameter.u32 += step.u32;
+                break;
+
+            case TYPE_UINT_64:
+                if (step.u64 > UINT64_MAX - par->parameter.u64) par->parameter.u64 = UINT64_MAX;
+                else par->parameter.u64 += step.u64;
+                break;
+
+            case TYPE_FLOAT: par->parameter.f += step.f; break;
+        }
+    }
+
+    // Parameter decrease
+    else
+    {
+        // Subtract the step value from the current parameter value by the current type
+        // Switch with low-side limitation for LIMITATION overflow setting (else - we don't care 
+        // about subtraction overflow for the unsigned types, cause it rotates to the maximal limit anyway)
+        switch (par->type)
+        {
+            case TYPE_UNS_INT:
+                if (par->overflow_mode == LIMITATION)
+                {
+                    if (par->parameter.uns_int <= step.uns_int)
+                        par->parameter.uns_int = par->min_val.uns_int;
+                    else
+                        par->parameter.uns_int -= step.uns_int;
+                }
+                else
+                {
+                    par->parameter.uns_int -= step.uns_int;
+                }
+                break;
+            
+            // Signed type don't requires a low-side limitation for LIMITATION overflow setting
+            case TYPE_INT:
+                par->parameter.int_val -= step.int_val;
+                break;
+        
+            case TYPE_UINT_8:
+                if (par->overflow_mode == LIMITATION)
+                {
+                    if (par->parameter.u8 <= step.u8)
+                        par->parameter.u8 = par->min_val.u8;
+                    else
+                        par->parameter.u8 -= step.u8;
+                }
+                else
+                {
+                    par->parameter.u8 -= step.u8;
+                }
+                break;
+        
+            case TYPE_UINT_16:
+                if (par->overflow_mode == LIMITATION)
+                {
+                    if (par->parameter.u16 <= step.u16)
+                        par->parameter.u16 = par->min_val.u16;
+                    else
+                        par->parameter.u16 -= step.u16;
+                }
+                else
+                {
+                    par->parameter.u16 -= step.u16;
+                }
+                break;
+        
+            case TYPE_UINT_32:
+                if (par->overflow_mode == LIMITATION)
+                {
+                    if (par->parameter.u32 <= step.u32)
+                        par->parameter.u32 = par->min_val.u32;
+                    else
+                        par->parameter.u32 -= step.u32;
+                }
+                else
+                {
+                    par->parameter.u32 -= step.u32;
+                }
+                break;
+        
+            case TYPE_UINT_64:
+                if (par->overflow_mode == LIMITATION)
+                {
+                    if (par->parameter.u64 <= step.u64)
+                        par->parameter.u64 = par->min_val.u64;
+                    else
+                        par->parameter.u64 -= step.u64;
+                }
+                else
+                {
+                    par->parameter.u64 -= step.u64;
+                }
+                break;
+            
+            // Signed type don't requires a low-side limitation for LIMITATION overflow setting
+            case TYPE_FLOAT:
+                par->parameter.f -= step.f;
+                break;
+        }
+    }
+
+
+    // Limitations setup (the index mapping has the index limitation only)
+    // If we choose to obtain the current limit value with limit overflow
+    if (!par->lut && par->overflow_mode == LIMITATION)
+    {
+        switch (par->type)
+        {
+            // Limitation by the current parameter value compare with selected limits for selected data type
+            case TYPE_UNS_INT:
+                if ((int)par->parameter.uns_int < (int)par->min_val.uns_int)
+                    par->parameter.uns_int = par->min_val.uns_int;
+
+                if ((int)par->parameter.uns_int > (int)par->max_val.uns_int)
+                    par->parameter.uns_int = par->max_val.uns_int;
+                break;
+    
+            case TYPE_INT:
+                if (par->parameter.int_val < par->min_val.int_val)
+                    par->parameter.int_val = par->min_val.int_val;
+                if (par->parameter.int_val > par->max_val.int_val)
+                    par->parameter.int_val = par->max_val.int_val;
+                break;
+
+            case TYPE_UINT_8:
+                if ((int)par->parameter.u8 < (int)par->min_val.u8)
+                    par->parameter.u8 = par->min_val.u8;
+
+                if ((int)par->parameter.u8 > (int)par->max_val.u8)
+                    par->parameter.u8 = par->max_val.u8;
+                break;
+
+            case TYPE_UINT_16:
+                if ((long)par->parameter.u16 < (long)par->min_val.u16)
+                    par->parameter.u16 = par->min_val.u16;
+
+                if ((long)par->parameter.u16 > (long)par->max_val.u16)
+                    par->parameter.u16 = par->max_val.u16;
+                break;
+    
+            case TYPE_UINT_32:
+                if ((long long)par->parameter.u32 < (long long)par->min_val.u32)
+                    par->parameter.u32 = par->min_val.u32;
+
+                if ((long long)par->parameter.u32 > (long long)par->max_val.u32)
+                    par->parameter.u32 = par->max_val.u32;
+                break;
+    
+            case TYPE_UINT_64:
+                if ((double)par->parameter.u64 < (double)par->min_val.u64)
+                    par->parameter.u64 = par->min_val.u64;
+
+                if ((double)par->parameter.u64 > (double)par->max_val.u64)
+                    par->parameter.u64 = par->max_val.u64;
+                break;
+    
+            case TYPE_FLOAT:
+                if (par->parameter.f < par->min_val.f)
+                    par->parameter.f = par->min_val.f;
+                if (par->parameter.f > par->max_val.f)
+                    par->parameter.f = par->max_val.f;
+                break;
+        }
+    }
+
+    // If we choose to obtain the other limit value with limit overflow        
+    else if (!par->lut && par->overflow_mode == ROTATION)
+    {
+        // Overflow fix for the wrap event
+        wrapped = par_value_compare(par->type, &par->parameter, &par->min_val) < 0 ||
+                  par_value_compare(par->type, &par->parameter, &par->max_val) > 0;
+
+        switch (par->type)
+        {
+            // Value change to other limit by the current parameter value compare with selected limits for selected data type
+            case TYPE_UNS_INT:
+                if ((int)par->parameter.uns_int < (int)par->min_val.uns_int)
+                    par->parameter.uns_int = par->max_val.uns_int;
+                if ((int)par->parameter.uns_int > (int)par->max_val.uns_int)
+                    par->parameter.uns_int = par->min_val.uns_int;
+                break;
+    
+            case TYPE_INT:
+                if (par->parameter.int_val < par->min_val.int_val)
+                    par->parameter.int_val = par->max_val.int_val;
+                if (par->parameter.int_val > par->max_val.int_val)
+                    par->parameter.int_val = par->min_val.int_val;
+                break;
+    
+            case TYPE_UINT_8:
+                if ((int)par->parameter.u8 < (int)par->min_val.u8)
+                    par->parameter.u8 = par->max_val.u8;
+                if ((int)par->parameter.u8 > (int)par->max_val.u8)
+                    par->parameter.u8 = par->min_val.u8;
+                break;
+
+            case TYPE_UINT_16:
+                if ((int)par->parameter.u16 < (int)par->min_val.u16)
+                    par->parameter.u16 = par->max_val.u16;
+                if ((int)par->parameter.u16 > (int)par->max_val.u16)
+                    par->parameter.u16 = par->min_val.u16;
+                break;
+    
+            case TYPE_UINT_32:
+                if ((long long)par->parameter.u32 < (long long)par->min_val.u32)
+                    par->parameter.u32 = par->max_val.u32;
+                if ((long long)par->parameter.u32 > (long long)par->max_val.u32)
+                    par->parameter.u32 = par->min_val.u32;
+                break;
+    
+            case TYPE_UINT_64:
+                if ((double)par->parameter.u64 < (double)par->min_val.u64)
+                    par->parameter.u64 = par->max_val.u64;
+                if ((double)par->parameter.u64 > (double)par->max_val.u64)
+                    par->parameter.u64 = par->min_val.u64;
+                break;
+    
+            case TYPE_FLOAT:
+                if (par->parameter.f < par->min_val.f)
+                    par->parameter.f = par->max_val.f;
+                if (par->parameter.f > par->max_val.f)
+                    par->parameter.f = par->min_val.f;
+                break;
+        }
+    }
+
+    // Real value change (the value, saved by the limitation, is not written and not reported)
+    bool changed = par_value_compare(par->type, &previous_value, &par->parameter) != 0;
+
+    if (changed)
+    {
+        // Update the parameter value by the link with dependence from selected data type 
+        switch (par->type) {
+            case TYPE_UNS_INT: *(unsigned int*)par->link = par->parameter.uns_int; break;
+            case TYPE_INT:     *(int*)par->link = par->parameter.int_val; break;
+            case TYPE_UINT_8: *(uint8_t*)par->link = par->parameter.u8; break;
+            case TYPE_UINT_16: *(uint16_t*)par->link = par->parameter.u16; break;
+            case TYPE_UINT_32: *(uint32_t*)par->link = par->parameter.u32; break;
+            case TYPE_UINT_64: *(uint64_t*)par->link = par->parameter.u64; break;
+            case TYPE_FLOAT:   *(float*)par->link = par->parameter.f; break;
+        }
+
+        // Bank dirty bitmap mark for the incremental redraw
+        enc_dirty_mark(encoder, par);
+    }
+
+    // Events generation for the accepted detent
+    enc_rotation_events_push(encoder, par, detent_direction, changed, wrapped);
+
+    // Press-and-turn event value after the coarse step (the event is added by the input processing)
+    if (press_turn) enc_event_value_update(encoder, ENC_EVENT_PRESS_TURN);
+
+    // ENCODER CONTROL LOOP END
+}
+
+
+// Rotary-sensor position control by the encoder rotation (and the index channel) without the controlled parameter
+int8_t enc_position_control(encoder_ctx *encoder)
+{
+    // Error handler
+    if (!encoder || encoder->ENC_CLK == GPIO_PIN_NONE || encoder->ENC_DT == GPIO_PIN_NONE) return 0;
+
+    return enc_input_control(encoder);
+}
+
+
+// SW-button clicks control by the button_control library with the click events generation
+void enc_sw_click_control(encoder_ctx *encoder)
+{
+    // Error handler
+    if (!encoder) return;
+
+    // The gesture engine reports the SW clicks by itself (one physical click - one event)
+    if (encoder->gestures_enabled) return;
+
+    if (enc_sw_click_read(encoder)) enc_event_push(encoder, ENC_EVENT_SW_CLICK, 1);
+}
+
+
+// Index mapping setup for the parameter by the precomputed values table
+void encoder_parameter_lut_setup(encoder_parameter *par, const parameter_value_union *lut, uint16_t size, uint16_t start_index)
+{
+    // Error handler
+    if (!par) return;
+
+    // Linear stepping return
+    if (!lut || size == 0)
+    {
+        par->lut = NULL;
+        par->lut_size = 0;
+        par->lut_index = 0;
+
+        return;
+    }
+
+    par->lut = lut;
+    par->lut_size = size;
+    par->lut_index = (start_index < size) ? start_index : size - 1;
+    par->parameter = lut[par->lut_index];
+
+    // Start value into the controlled variable
+    if (!par->link) return;
+
+    switch (par->type)
+    {
+        case TYPE_UNS_INT: *(unsigned int*)par->link = par->parameter.uns_int; break;
+        case TYPE_INT:     *(int*)par->link = par->parameter.int_val; break;
+        case TYPE_UINT_8: *(uint8_t*)par->link = par->parameter.u8; break;
+        case TYPE_UINT_16: *(uint16_t*)par->link = par->parameter.u16; break;
+        case TYPE_UINT_32: *(uint32_t*)par->link = par->parameter.u32; break;
+        case TYPE_UINT_64: *(uint64_t*)par->link = par->parameter.u64; break;
+        case TYPE_FLOAT:   *(float*)par->link = par->parameter.f; break;
+    }
+}
+
+
+// Logarithmic scale values table generation: min_val * (max_val / min_val) ^ (i / (size - 1))
+// Floating-point calculations are used only here, at the initialization
+void encoder_lut_log_fill(parameter_value_union *lut, uint16_t size, parameter_type type, float min_val, float max_val)
+{
+    // Error handler (logarithmic scale requires the positive limits)
+    if (!lut || size == 0 || min_val <= 0.0f || max_val <= 0.0f) return;
+
+    if (size == 1)
+    {
+        lut[0] = par_value_from_float(type, min_val);
+        return;
+    }
+
+    float log_ratio = logf(max_val / min_val);
+
+    for (uint16_t i = 0; i < size; i++)
+    {
+        lut[i] = par_value_from_float(type, min_val * expf(log_ratio * (float)i / (float)(size - 1)));
+    }
+}
+
+
+// Preferred numbers series values table generation by decades: series[i % series_len] * first_multiplier * 10 ^ (i / series_len)
+void encoder_lut_series_fill(parameter_value_union *lut, uint16_t size, parameter_type type,
+    const uint16_t *series, uint8_t series_len, float first_multiplier) {
+
+    // Error handler
+    if (!lut || !series || series_len == 0) return;
+
+    float multiplier = first_multiplier;
+
+    for (uint16_t i = 0; i < size; i++)
+    {
+        // Next decade
+        if (i != 0 && i % series_len == 0) multiplier *= 10.0f;
+
+        lut[i] = par_value_from_float(type, (float)series[i % series_len] * multiplier);
+    }
+}
+
+
+// Gesture engine setup with the selected configuration (NULL - default configuration)
+void encoder_gesture_setup(encoder_ctx *encoder, const encoder_gesture_config *config)
+{
+    // Error handler
+    if (!encoder) return;
+
+    encoder->gesture_config = config ? *config : encoder_gesture_config_default();
+
+    // Coarse step error handler
+    if (encoder->gesture_config.coarse_multiplier == 0) encoder->gesture_config.coarse_multiplier = 1;
+
+    // SW state reset
+    encoder->sw_raw_state = false;
+    encoder->sw_raw_change_us = 0;
+    encoder->sw_pressed = false;
+    encoder->sw_clicks = 0;
+    encoder->sw_long_sent = false;
+    encoder->sw_turned = false;
+    encoder->last_detent_us = 0;
+
+    encoder->gestures_enabled = true;
+}
+
+
+// Idle mode setup by the quiet period (0 - idle mode disable)
+void encoder_idle_setup(encoder_ctx *encoder, uint32_t quiet_us)
+{
+    // Error handler
+    if (!encoder) return;
+
+    encoder->idle_quiet_us = quiet_us;
+}
+
+
+// Idle mode readiness check: quiet period without the input changes and without the unfinished SW gestures
+bool encoder_idle_ready(encoder_ctx *encoder)
+{
+    // Error handler
+    if (!encoder || encoder->idle_quiet_us == 0 || encoder->idle_armed) return false;
+
+    // Scan bus lines can't wake the controller up
+    if (encoder->scan_bus) return false;
+
+    // SW-button hold or click, waiting for the double click
+    if (encoder->last_input.sw || encoder->sw_pressed || encoder->sw_clicks != 0) return false;
+
+    return enc_time_now_us() - encoder->last_activity_us >= (int64_t)encoder->idle_quiet_us;
+}
+
+
+// Edge wakeups arm on CLK/DT/SW before the caller sleep
+void encoder_idle_enter(encoder_ctx *encoder)
+{
+    // Error handler
+    if (!encoder || encoder->idle_armed) return;
+
+    // Wakeup by the levels, opposite to the last decoded snapshot
+    enc_pin_wakeup_arm(encoder->ENC_CLK, encoder->last_input.clk);
+    enc_pin_wakeup_arm(encoder->ENC_DT, encoder->last_input.dt);
+    enc_pin_wakeup_arm(encoder->ENC_SW, !encoder->last_input.sw); // Pressed SW is low level
+
+    esp_sleep_enable_gpio_wakeup();
+
+    encoder->idle_enter_us = enc_time_now_us();
+    encoder->idle_armed = true;
+}
+
+
+// Edge wakeups disarm after the caller sleep with the sleep time accounting
+// The decoder states are kept from the last control call, so the first detent is processed by the next call
+void encoder_idle_exit(encoder_ctx *encoder)
+{
+    // Error handler
+    if (!encoder || !encoder->idle_armed) return;
+
+    if (encoder->ENC_CLK != GPIO_PIN_NONE) gpio_wakeup_disable(encoder->ENC_CLK);
+    if (encoder->ENC_DT != GPIO_PIN_NONE) gpio_wakeup_disable(encoder->ENC_DT);
+    if (encoder->ENC_SW != GPIO_PIN_NONE) gpio_wakeup_disable(encoder->ENC_SW);
+
+    encoder->idle_exit_us = enc_time_now_us();
+    encoder->idle_armed = false;
+
+    encoder->power_stats.sleep_us += encoder->idle_exit_us - encoder->idle_enter_us;
+    encoder->power_stats.wakeups++;
+    encoder->exit_poll_pending = true;
+
+    // Fast polling after the wakeup by the edge
+    if (encoder->poll_enabled)
+    {
+        encoder->poll_interval_us = encoder->poll_config.min_interval_us;
+        encoder->next_poll_us = encoder->idle_exit_us;
+    }
+}
+
+
+// Power accounting statistics with the awake time calculation
+void encoder_power_stats_get(encoder_ctx *encoder, encoder_power_stats *stats)
+{
+    // Error handler
+    if (!encoder || !stats) return;
+
+    *stats = encoder->power_stats;
+
+    int64_t total_us = enc_time_now_us() - encoder->power_stats_start_us;
+
+    // Current sleep is not finished yet
+    if (encoder->idle_armed) stats->sleep_us += enc_time_now_us() - encoder->idle_enter_us;
+
+    stats->awake_us = total_us - stats->sleep_us;
+}
+
+
+// Power accounting statistics reset
+void encoder_power_stats_reset(encoder_ctx *encoder)
+{
+    // Error handler
+    if (!encoder) return;
+
+    encoder->power_stats = (encoder_power_stats){0};
+    encoder->power_stats_start_us = enc_time_now_us();
+
+    if (encoder->idle_armed) encoder->idle_enter_us = encoder->power_stats_start_us;
+}
+
+
+// Awake time part in per mille (1000 - continuous polling)
+uint16_t encoder_power_duty_cycle_permille(const encoder_power_stats *stats)
+{
+    // Error handler
+    if (!stats) return 1000;
+
+    int64_t total_us = stats->awake_us + stats->sleep_us;
+
+    if (total_us <= 0) return 1000;
+
+    return (uint16_t)((stats->awake_us * 1000) / total_us);
+}
+
+
+// Number of the control calls, which continuous polling with the selected period would make for the same time
+uint32_t encoder_power_continuous_polls(const encoder_power_stats *stats, uint32_t poll_period_us)
+{
+    // Error handler
+    if (!stats || poll_period_us == 0) return 0;
+
+    return (uint32_t)((stats->awake_us + stats->sleep_us) / poll_period_us);
+}
+
+
+// Index channel setup: Z pin, counts per revolution for the drift check (0 - no check) and the drift correction
+void encoder_index_setup(encoder_ctx *encoder, gpio_num_t z_pin, uint32_t counts_per_rev, bool correction)
+{
+    // Error handler
+    if (!encoder) return;
+
+    encoder->ENC_Z = z_pin;
+    encoder->counts_per_rev = counts_per_rev;
+    encoder->index_correction = correction;
+    encoder->index_direction = 0;
+    encoder->index_latched[0] = false;
+    encoder->index_latched[1] = false;
+
+    // Encoder Z initialization (the bus line for the scanned encoder)
+    if (encoder->ENC_Z != GPIO_PIN_NONE && !encoder->scan_bus)
+    {
+        gpio_set_direction(encoder->ENC_Z, GPIO_MODE_INPUT);
+        gpio_set_pull_mode(encoder->ENC_Z, GPIO_PULLUP_ONLY);
+    }
+
+    // Initial Z state for the rising edge fix
+    enc_input_read(encoder, &encoder->last_input);
+}
+
+
+// Homing start: the position is set to home_position by the next index pulse
+void encoder_homing_start(encoder_ctx *encoder, int32_t home_position)
+{
+    // Error handler
+    if (!encoder || encoder->ENC_Z == GPIO_PIN_NONE) return;
+
+    encoder->home_position = home_position;
+    encoder->homing_state = ENC_HOMING_SEEK;
+}
+
+
+// Homing result check
+bool encoder_is_homed(const encoder_ctx *encoder)
+{
+    return encoder && encoder->homing_state == ENC_HOMING_DONE;
+}
+
+
+// Position history attach with the current position as the first sample
+void encoder_history_attach(encoder_ctx *encoder, encoder_history *history)
+{
+    // Error handler
+    if (!encoder) return;
+
+    encoder->history = history;
+
+    if (history) encoder_history_append(history, enc_time_now_us(), encoder->position);
+}
+
+
+// Dirty bitmap attach: table entries use base_bit + index, the other parameters use base_bit
+void encoder_dirty_attach(encoder_ctx *encoder, encoder_dirty_map *map, uint16_t base_bit)
+{
+    // Error handler
+    if (!encoder) return;
+
+    encoder->dirty_map = map;
+    encoder->dirty_base_bit = base_bit;
+}
+
+
+// Atomic dirty bit set
+void encoder_dirty_set(encoder_dirty_map *map, uint16_t bit)
+{
+    // Error handler
+    if (!map || bit >= ENC_DIRTY_MAP_BITS) return;
+
+    __atomic_fetch_or(&map->words[bit >> 5], 1u << (bit & 31), __ATOMIC_RELEASE);
+}
+
+
+// First set bit search (find-first-set per word) with the atomic clear
+int encoder_dirty_next(encoder_dirty_map *map)
+{
+    // Error handler
+    if (!map) return -1;
+
+    for (uint16_t w = 0; w < ENC_DIRTY_MAP_WORDS; w++)
+    {
+        uint32_t word = __atomic_load_n(&map->words[w], __ATOMIC_ACQUIRE);
+
+        while (word)
+        {
+            uint32_t mask = 1u << __builtin_ctz(word);
+
+            // Clear with the check - the bit could be taken by the other consumer
+            uint32_t previous = __atomic_fetch_and(&map->words[w], ~mask, __ATOMIC_ACQ_REL);
+
+            if (previous & mask) return (int)(w * 32 + __builtin_ctz(mask));
+
+            word = previous & ~mask;
+        }
+    }
+
+    return -1;
+}
+
+
+// Any set bit check
+bool encoder_dirty_any(const encoder_dirty_map *map)
+{
+    // Error handler
+    if (!map) return false;
+
+    for (uint16_t w = 0; w < ENC_DIRTY_MAP_WORDS; w++)
+    {
+        if (__atomic_load_n(&map->words[w], __ATOMIC_ACQUIRE)) return true;
+    }
+
+    return false;
+}
+
+
+// Shift registers (74HC165-style) scan bus initialization: PL - parallel load (active low), CP - shift clock, Q7 - serial data
+void encoder_scan_bus_shift_register_init(encoder_scan_bus *bus, gpio_num_t load_pin, gpio_num_t clock_pin, gpio_num_t data_pin, uint16_t lines)
+{
+    // Error handler
+    if (!bus) return;
+
+    *bus = (encoder_scan_bus){0};
+
+    bus->backend = ENC_SCAN_SHIFT_REGISTER;
+    bus->load_pin = load_pin;
+    bus->clock_pin = clock_pin;
+    bus->data_pin = data_pin;
+
+    // Pins error handler - the bus without the lines (the bursts are failed)
+    if (load_pin == GPIO_PIN_NONE || clock_pin == GPIO_PIN_NONE || data_pin == GPIO_PIN_NONE) return;
+
+    bus->lines = (lines < ENC_SCAN_BUS_MAX_LINES) ? lines : ENC_SCAN_BUS_MAX_LINES;
+
+    // Burst: load pulse + one clock per line
+    bus->clocks_per_byte = 8;
+    bus->frame_clocks = 2;
+    bus->burst_clocks = bus->frame_clocks + bus->lines;
+
+    // Pins setup
+    gpio_set_direction(load_pin, GPIO_MODE_OUTPUT);
+    gpio_set_level(load_pin, 1);
+
+    gpio_set_direction(clock_pin, GPIO_MODE_OUTPUT);
+    gpio_set_level(clock_pin, 0);
+
+    gpio_set_direction(data_pin, GPIO_MODE_INPUT);
+}
+
+
+// User read function scan bus initialization (I2C/SPI expanders or the simulated expander)
+void encoder_scan_bus_user_init(encoder_scan_bus *bus, encoder_scan_read_fn read, void *user_data, uint16_t lines,
+    uint16_t clocks_per_byte, uint16_t frame_clocks) {
+
+    // Error handler
+    if (!bus) return;
+
+    *bus = (encoder_scan_bus){0};
+
+    bus->backend = ENC_SCAN_USER;
+    bus->read = read;
+    bus->user_data = user_data;
+    bus->lines = (lines < ENC_SCAN_BUS_MAX_LINES) ? lines : ENC_SCAN_BUS_MAX_LINES;
+
+    // Burst: frame + whole bytes of the lines
+    bus->clocks_per_byte = clocks_per_byte;
+    bus->frame_clocks = frame_clocks;
+    bus->burst_clocks = frame_clocks + (uint32_t)clocks_per_byte * ((bus->lines + 7) / 8);
+}
+
+
+// One burst read of all the bus lines into the snapshot
+bool encoder_scan_bus_read(encoder_scan_bus *bus)
+{
+    // Error handler
+    if (!bus) return false;
+
+    if (bus->backend == ENC_SCAN_USER)
+    {
+        if (!bus->read || !bus->read(bus->user_data, bus->snapshot, (bus->lines + 7) / 8))
+        {
+            bus->scan_errors++;
+            return false;
+        }
+
+        bus->scans++;
+        return true;
+    }
+
+    // Shift registers pins error handler
+    if (bus->load_pin == GPIO_PIN_NONE || bus->clock_pin == GPIO_PIN_NONE || bus->data_pin == GPIO_PIN_NONE)
+    {
+        bus->scan_errors++;
+        return false;
+    }
+
+    uint8_t snapshot[ENC_SCAN_BUS_BYTES] = {0};
+
+    // Parallel inputs latch
+    fast_gpio_write(bus->load_pin, 0);
+    fast_gpio_write(bus->load_pin, 1);
+
+    // Serial shift: Q7 shows H of the nearest chip after the load, then the next line after each clock
+    for (uint16_t line = 0; line < bus->lines; line++)
+    {
+        snapshot[line >> 3] |= (uint8_t)(fast_gpio_read(bus->data_pin) << (line & 7));
+
+        fast_gpio_write(bus->clock_pin, 1);
+        fast_gpio_write(bus->clock_pin, 0);
+    }
+
+    for (uint8_t i = 0; i < ENC_SCAN_BUS_BYTES; i++) bus->snapshot[i] = snapshot[i];
+
+    bus->scans++;
+
+    return true;
+}
+
+
+// Scanned encoder attach: the encoder pins are replaced by the bus lines (GPIO_PIN_NONE - no line)
+void encoder_scan_attach(encoder_ctx *encoder, encoder_scan_bus *bus, gpio_num_t sw_line, gpio_num_t dt_line, gpio_num_t clk_line)
+{
+    // Error handler
+    if (!encoder || !bus) return;
+
+    encoder->scan_bus = bus;
+    encoder->ENC_SW = sw_line;
+    encoder->ENC_DT = dt_line;
+    encoder->ENC_CLK = clk_line;
+
+    // Initial states from the current snapshot
+    enc_input_read(encoder, &encoder->last_input);
+    enc_decoder_sync(encoder);
+}
+
+
+// Scan bus capacity by the scan clock: burst time, scan rate, detent rate per encoder and the encoders number for the target detent rate
+// Quadrature decoding needs 4 snapshots per quadrature period (one per CLK/DT state), the CLK edge decoder takes one detent per debounce time
+void encoder_scan_bus_capacity(const encoder_scan_bus *bus, uint32_t scan_clock_hz, uint8_t lines_per_encoder,
+    uint32_t target_detent_rate_hz, encoder_scan_capacity *capacity) {
+
+    // Error handler
+    if (!bus || !capacity) return;
+
+    *capacity = (encoder_scan_capacity){0};
+
+    if (scan_clock_hz == 0 || bus->burst_clocks == 0) return;
+
+    // Burst time and the continuous scan rate
+    capacity->burst_ns = (uint32_t)(((uint64_t)bus->burst_clocks * 1000000000ULL) / scan_clock_hz);
+    capacity->max_scan_rate_hz = scan_clock_hz / bus->burst_clocks;
+    capacity->max_detent_rate_hz = capacity->max_scan_rate_hz / 4;
+
+    uint32_t debounce_rate_hz = 1000 / ENC_CLK_EDGE_DEBOUNCE_MS;
+    capacity->max_detent_rate_clk_edge_hz = (capacity->max_detent_rate_hz < debounce_rate_hz) ? capacity->max_detent_rate_hz : debounce_rate_hz;
+
+    if (lines_per_encoder == 0) return;
+
+    // Buffer limit: lines inside the snapshot
+    capacity->max_encoders_buffer = (uint16_t)(ENC_SCAN_BUS_MAX_LINES / lines_per_encoder);
+
+    // Bus limit: clocks per burst for the target rate minus the frame, the data by the whole bytes for the user backend
+    if (target_detent_rate_hz == 0 || bus->clocks_per_byte == 0) return;
+
+    uint64_t clocks_per_burst = scan_clock_hz / ((uint64_t)target_detent_rate_hz * 4);
+
+    if (clocks_per_burst <= bus->frame_clocks) return;
+
+    uint64_t data_clocks = clocks_per_burst - bus->frame_clocks;
+    uint64_t lines = (bus->backend == ENC_SCAN_USER) ? (data_clocks / bus->clocks_per_byte) * 8 : (data_clocks * 8) / bus->clocks_per_byte;
+    uint64_t encoders = lines / lines_per_encoder;
+
+    capacity->max_encoders = (encoders > UINT16_MAX) ? UINT16_MAX : (uint16_t)encoders;
+}
+
+
+// Decoder selection with the decoder states sync and the recovery counters reset
+void encoder_decoder_setup(encoder_ctx *encoder, encoder_decoder_mode mode)
+{
+    // Error handler
+    if (!encoder) return;
+
+    encoder->decoder_mode = mode;
+    encoder->recovered_steps = 0;
+    encoder->ambiguous_steps = 0;
+
+    enc_input_read(encoder, &encoder->last_input);
+    enc_decoder_sync(encoder);
+}
+
+
+// Adaptive polling setup (NULL - default configuration)
+void encoder_poll_setup(encoder_ctx *encoder, const encoder_poll_config *config)
+{
+    // Error handler
+    if (!encoder) return;
+
+    encoder->poll_config = config ? *config : encoder_poll_config_default();
+
+    // Configuration error handler
+    if (encoder->poll_config.phase_samples == 0) encoder->poll_config.phase_samples = 1;
+    if (encoder->poll_config.max_interval_us < encoder->poll_config.min_interval_us)
+        encoder->poll_config.max_interval_us = encoder->poll_config.min_interval_us;
+
+    encoder->poll_interval_us = encoder->poll_config.min_interval_us;
+    encoder->next_poll_us = enc_time_now_us();
+
+    encoder->poll_enabled = true;
+}
+
+
+// Recommended next control call time
+int64_t encoder_next_poll_us(const encoder_ctx *encoder)
+{
+    // Error handler
+    if (!encoder || !encoder->poll_enabled) return enc_time_now_us();
+
+    return encoder->next_poll_us;
+}
+
+
+// Earliest next control call time of the encoders bank
+int64_t encoder_bank_next_poll_us(const encoder_ctx *encoders, size_t count)
+{
+    // Error handler
+    if (!encoders || count == 0) return enc_time_now_us();
+
+    int64_t deadline_us = encoder_next_poll_us(&encoders[0]);
+
+    for (size_t i = 1; i < count; i++)
+    {
+        int64_t next_us = encoder_next_poll_us(&encoders[i]);
+        if (next_us < deadline_us) deadline_us = next_us;
+    }
+
+    return deadline_us;
+}
+
+
+// Parameters table binding with the one-time values converting for all the table entries
+void encoder_parameter_table_bind(encoder_ctx *encoder, encoder_parameter *table, uint8_t count, bool sw_switch)
+{
+    // Error handler
+    if (!encoder) return;
+
+    if (!table || count == 0)
+    {
+        encoder->parameter_table = NULL;
+        encoder->parameter_count = 0;
+        encoder->active_index = 0;
+        encoder->active_parameter = NULL;
+        encoder->sw_table_switch = false;
+
+        return;
+    }
+
+    // Cached values loading from the controlled variables (from the values tables for the index mapping)
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (table[i].lut) encoder_parameter_lut_setup(&table[i], table[i].lut, table[i].lut_size, table[i].lut_index);
+        else if (table[i].link) par_link_load(&table[i]);
+    }
+
+    encoder->parameter_table = table;
+    encoder->parameter_count = count;
+    encoder->sw_table_switch = sw_switch;
+
+    encoder_parameter_select(encoder, 0);
+}
+
+
+// Active table entry switch by index - pointer update only, without the values converting
+void encoder_parameter_select(encoder_ctx *encoder, uint8_t index)
+{
+    // Error handler
+    if (!encoder || !encoder->parameter_table || index >= encoder->parameter_count) return;
+
+    encoder->active_index = index;
+    encoder->active_parameter = &encoder->parameter_table[index];
+}
+
+
+// Next table entry switch with the rotation to the first entry after the last one
+void encoder_parameter_next(encoder_ctx *encoder)
+{
+    // Error handler
+    if (!encoder || !encoder->parameter_table) return;
+
+    uint8_t index = encoder->active_index + 1;
+
+    encoder_parameter_select(encoder, (index >= encoder->parameter_count) ? 0 : index);
+}
+
+
+// Active table entry control by the encoder rotation with the SW-button entries switch
+void enc_table_rotation_control(encoder_ctx *encoder)
+{
+    // Error handler
+    if (!encoder || !encoder->parameter_table) return;
+
+    // Table entry switch by the SW-button click (the gesture engine switches the entries by itself)
+    if (encoder->sw_table_switch && !encoder->gestures_enabled && enc_sw_click_read(encoder))
+    {
+        encoder_parameter_next(encoder);
+        enc_event_push(encoder, ENC_EVENT_SW_CLICK, 1);
+    }
+
+    // Table control call after the direct parameter control - active entry restore
+    encoder->active_parameter = &encoder->parameter_table[encoder->active_index];
+
+    enc_parameter_rotation_control(encoder, encoder->active_parameter);
+}
+
+
+// Subscriber set for the selected event type
+void encoder_event_subscribe(encoder_ctx *encoder, encoder_event_type type, encoder_event_callback callback, void *user_data)
+{
+    // Error handler
+    if (!encoder || type >= ENC_EVENT_COUNT) return;
+
+    encoder->callbacks[type] = callback;
+    encoder->callbacks_user_data[type] = user_data;
+}
+
+
+// Oldest event taking from the queue
+bool encoder_event_pop(encoder_ctx *encoder, encoder_event *event)
+{
+    // Error handler
+    if (!encoder || !event || encoder->event_count == 0) return false;
+
+    *event = encoder->event_queue[encoder->event_head];
+
+    encoder->event_head = (encoder->event_head + 1) % ENC_EVENT_QUEUE_SIZE;
+    encoder->event_count--;
+
+    return true;
+}
+
+
+// All pending events taking with the subscribers calls
+uint8_t encoder_events_dispatch(encoder_ctx *encoder)
+{
+    encoder_event event;
+    uint8_t dispatched = 0;
+
+    while (encoder_event_pop(encoder, &event))
+    {
+        if (encoder->callbacks[event.type])
+            encoder->callbacks[event.type](encoder, &event, encoder->callbacks_user_data[event.type]);
+
+        dispatched++;
+    }
+
+    return dispatched;
 }
 
 
@@ -533,58 +2106,58 @@ void par_type_converting(encoder_ctx *encoder, parameter_type type, void *parame
     // Parameter type switch by the selected type
     switch (type) {
         case TYPE_UNS_INT:
-            encoder->parameter.uns_int = *(unsigned int*)parameter;
-            encoder->step.uns_int = *(unsigned int*)step;
-            encoder->min_val.uns_int = *(unsigned int*)min_val;
-            encoder->max_val.uns_int = *(unsigned int*)max_val;
+            encoder->direct_parameter.parameter.uns_int = *(unsigned int*)parameter;
+            encoder->direct_parameter.step.uns_int = *(unsigned int*)step;
+            encoder->direct_parameter.min_val.uns_int = *(unsigned int*)min_val;
+            encoder->direct_parameter.max_val.uns_int = *(unsigned int*)max_val;
             
             break;
 
         case TYPE_INT:
-            encoder->parameter.int_val = *(int*)parameter;
-            encoder->step.int_val = *(int*)step;
-            encoder->min_val.int_val = *(int*)min_val;
-            encoder->max_val.int_val = *(int*)max_val;
+            encoder->direct_parameter.parameter.int_val = *(int*)parameter;
+            encoder->direct_parameter.step.int_val = *(int*)step;
+            encoder->direct_parameter.min_val.int_val = *(int*)min_val;
+            encoder->direct_parameter.max_val.int_val = *(int*)max_val;
 
             break;
 
         case TYPE_UINT_8:
-            encoder->parameter.u8 = *(uint8_t*)parameter;
-            encoder->step.u8 = *(uint8_t*)step;
-            encoder->min_val.u8 = *(uint8_t*)min_val;
-            encoder->max_val.u8 = *(uint8_t*)max_val;
+            encoder->direct_parameter.parameter.u8 = *(uint8_t*)parameter;
+            encoder->direct_parameter.step.u8 = *(uint8_t*)step;
+            encoder->direct_parameter.min_val.u8 = *(uint8_t*)min_val;
+            encoder->direct_parameter.max_val.u8 = *(uint8_t*)max_val;
 
             break;
 
         case TYPE_UINT_16:
-            encoder->parameter.u16 = *(uint16_t*)parameter;
-            encoder->step.u16 = *(uint16_t*)step;
-            encoder->min_val.u16 = *(uint16_t*)min_val;
-            encoder->max_val.u16 = *(uint16_t*)max_val;
+            encoder->direct_parameter.parameter.u16 = *(uint16_t*)parameter;
+            encoder->direct_parameter.step.u16 = *(uint16_t*)step;
+            encoder->direct_parameter.min_val.u16 = *(uint16_t*)min_val;
+            encoder->direct_parameter.max_val.u16 = *(uint16_t*)max_val;
 
             break;
 
         case TYPE_UINT_32:
-            encoder->parameter.u32 = *(uint32_t*)parameter;
-            encoder->step.u32 = *(uint32_t*)step;
-            encoder->min_val.u32 = *(uint32_t*)min_val;
-            encoder->max_val.u32 = *(uint32_t*)max_val;
+            encoder->direct_parameter.parameter.u32 = *(uint32_t*)parameter;
+            encoder->direct_parameter.step.u32 = *(uint32_t*)step;
+            encoder->direct_parameter.min_val.u32 = *(uint32_t*)min_val;
+            encoder->direct_parameter.max_val.u32 = *(uint32_t*)max_val;
 
             break;
 
         case TYPE_UINT_64:
-            encoder->parameter.u64 = *(uint64_t*)parameter;
-            encoder->step.u64 = *(uint64_t*)step;
-            encoder->min_val.u64 = *(uint64_t*)min_val;
-            encoder->max_val.u64 = *(uint64_t*)max_val;
+            encoder->direct_parameter.parameter.u64 = *(uint64_t*)parameter;
+            encoder->direct_parameter.step.u64 = *(uint64_t*)step;
+            encoder->direct_parameter.min_val.u64 = *(uint64_t*)min_val;
+            encoder->direct_parameter.max_val.u64 = *(uint64_t*)max_val;
 
             break;
 
         case TYPE_FLOAT:
-            encoder->parameter.f = *(float*)parameter;
-            encoder->step.f = *(float*)step;
-            encoder->min_val.f = *(float*)min_val;
-            encoder->max_val.f = *(float*)max_val;
+            encoder->direct_parameter.parameter.f = *(float*)parameter;
+            encoder->direct_parameter.step.f = *(float*)step;
+            encoder->direct_parameter.min_val.f = *(float*)min_val;
+            encoder->direct_parameter.max_val.f = *(float*)max_val;
 
             break;
 
@@ -604,46 +2177,46 @@ bool regulation_values_changed(encoder_ctx *encoder, parameter_type type, void *
     switch(type)
     {
         case TYPE_UNS_INT:
-            return (encoder->parameter.uns_int != *(unsigned int*)parameter) ||
-                   (encoder->step.uns_int != *(unsigned int*)step) ||
-                   (encoder->min_val.uns_int != *(unsigned int*)min_val) ||
-                   (encoder->max_val.uns_int != *(unsigned int*)max_val);
+            return (encoder->direct_parameter.parameter.uns_int != *(unsigned int*)parameter) ||
+                   (encoder->direct_parameter.step.uns_int != *(unsigned int*)step) ||
+                   (encoder->direct_parameter.min_val.uns_int != *(unsigned int*)min_val) ||
+                   (encoder->direct_parameter.max_val.uns_int != *(unsigned int*)max_val);
 
         case TYPE_INT:
-            return (encoder->parameter.int_val != *(int*)parameter) ||
-                   (encoder->step.int_val != *(int*)step) ||
-                   (encoder->min_val.int_val != *(int*)min_val) ||
-                   (encoder->max_val.int_val != *(int*)max_val);
+            return (encoder->direct_parameter.parameter.int_val != *(int*)parameter) ||
+                   (encoder->direct_parameter.step.int_val != *(int*)step) ||
+                   (encoder->direct_parameter.min_val.int_val != *(int*)min_val) ||
+                   (encoder->direct_parameter.max_val.int_val != *(int*)max_val);
 
         case TYPE_UINT_8:
-            return (encoder->parameter.u8 != *(uint8_t*)parameter) ||
-                    (encoder->step.u8 != *(uint8_t*)step) ||
-                    (encoder->min_val.u8 != *(uint8_t*)min_val) ||
-                    (encoder->max_val.u8 != *(uint8_t*)max_val);
+            return (encoder->direct_parameter.parameter.u8 != *(uint8_t*)parameter) ||
+                    (encoder->direct_parameter.step.u8 != *(uint8_t*)step) ||
+                    (encoder->direct_parameter.min_val.u8 != *(uint8_t*)min_val) ||
+                    (encoder->direct_parameter.max_val.u8 != *(uint8_t*)max_val);
 
         case TYPE_UINT_16:
-            return (encoder->parameter.u16 != *(uint16_t*)parameter) ||
-                   (encoder->step.u16 != *(uint16_t*)step) ||
-                   (encoder->min_val.u16 != *(uint16_t*)min_val) ||
-                   (encoder->max_val.u16 != *(uint16_t*)max_val);
+            return (encoder->direct_parameter.parameter.u16 != *(uint16_t*)parameter) ||
+                   (encoder->direct_parameter.step.u16 != *(uint16_t*)step) ||
+                   (encoder->direct_parameter.min_val.u16 != *(uint16_t*)min_val) ||
+                   (encoder->direct_parameter.max_val.u16 != *(uint16_t*)max_val);
 
         case TYPE_UINT_32:
-            return (encoder->parameter.u32 != *(uint32_t*)parameter) ||
-                   (encoder->step.u32 != *(uint32_t*)step) ||
-                   (encoder->min_val.u32 != *(uint32_t*)min_val) ||
-                   (encoder->max_val.u32 != *(uint32_t*)max_val);
+            return (encoder->direct_parameter.parameter.u32 != *(uint32_t*)parameter) ||
+                   (encoder->direct_parameter.step.u32 != *(uint32_t*)step) ||
+                   (encoder->direct_parameter.min_val.u32 != *(uint32_t*)min_val) ||
+                   (encoder->direct_parameter.max_val.u32 != *(uint32_t*)max_val);
 
         case TYPE_UINT_64:
-            return (encoder->parameter.u64 != *(uint64_t*)parameter) ||
-                   (encoder->step.u64 != *(uint64_t*)step) ||
-                   (encoder->min_val.u64 != *(uint64_t*)min_val) ||
-                   (encoder->max_val.u64 != *(uint64_t*)max_val);
+            return (encoder->direct_parameter.parameter.u64 != *(uint64_t*)parameter) ||
+                   (encoder->direct_parameter.step.u64 != *(uint64_t*)step) ||
+                   (encoder->direct_parameter.min_val.u64 != *(uint64_t*)min_val) ||
+                   (encoder->direct_parameter.max_val.u64 != *(uint64_t*)max_val);
 
         case TYPE_FLOAT:
-            return (encoder->parameter.f != *(float*)parameter) ||
-                   (encoder->step.f != *(float*)step) ||
-                   (encoder->min_val.f != *(float*)min_val) ||
-                   (encoder->max_val.f != *(float*)max_val);
+            return (encoder->direct_parameter.parameter.f != *(float*)parameter) ||
+                   (encoder->direct_parameter.step.f != *(float*)step) ||
+                   (encoder->direct_parameter.min_val.f != *(float*)min_val) ||
+                   (encoder->direct_parameter.max_val.f != *(float*)max_val);
 
         default:
             return false;
@@ -16,6 +16,65 @@
 // Empty pin name define 
 #define GPIO_PIN_NONE ((gpio_num_t)(-1))
 
+// Encoder events queue size (pending events of the same type are coalesced, so the queue holds the different types mostly)
+#ifndef ENC_EVENT_QUEUE_SIZE
+#define ENC_EVENT_QUEUE_SIZE 8
+#endif
+
+// CLK edge decoder rotation debounce without the gesture engine (milliseconds) - one detent per debounce time at most
+#define ENC_CLK_EDGE_DEBOUNCE_MS 3
+
+// Gesture engine default timings (microseconds) and press-and-turn step multiplier
+#define ENC_GESTURE_SW_DEBOUNCE_US_DEFAULT        5000
+#define ENC_GESTURE_ROTATION_DEBOUNCE_US_DEFAULT  3000
+#define ENC_GESTURE_DOUBLE_CLICK_US_DEFAULT       300000
+#define ENC_GESTURE_LONG_PRESS_US_DEFAULT         700000
+#define ENC_GESTURE_COARSE_MULTIPLIER_DEFAULT     10
+
+// Dirty bitmap size (bits) for the encoders bank parameters
+#ifndef ENC_DIRTY_MAP_BITS
+#define ENC_DIRTY_MAP_BITS 64
+#endif
+
+#define ENC_DIRTY_MAP_WORDS ((ENC_DIRTY_MAP_BITS + 31) / 32)
+
+// Scan bus lines limit (I/O expanders snapshot size)
+#ifndef ENC_SCAN_BUS_MAX_LINES
+#define ENC_SCAN_BUS_MAX_LINES 64
+#endif
+
+#define ENC_SCAN_BUS_BYTES ((ENC_SCAN_BUS_MAX_LINES + 7) / 8)
+
+// Shift registers chain line by the chip (0 - nearest to the MCU, its Q7 is the data pin) and the parallel input
+// (0 - A/D0 ... 7 - H/D7): after the parallel load Q7 outputs H first, so line 0 is H of the nearest chip
+#define ENC_SCAN_SHIFT_REGISTER_LINE(chip, input) ((chip) * 8 + 7 - (input))
+
+// Skipped quadrature state recovery window - the recent quarter step intervals number (and the unchanged polls number
+// of the pause or the reversal)
+#ifndef ENC_RECOVERY_INTERVALS
+#define ENC_RECOVERY_INTERVALS 4
+#endif
+
+// Slowest quarter step (microseconds) for the skipped state recovery - the longer pause restarts the velocity estimate
+#ifndef ENC_RECOVERY_MAX_INTERVAL_US
+#define ENC_RECOVERY_MAX_INTERVAL_US 50000
+#endif
+
+// Adaptive polling defaults: fastest and slowest poll intervals (microseconds) and polls per quadrature phase.
+// The first edges of the spin are seen up to the maximal interval late: 2 ms has no missed detents for the spins
+// with the quarter steps from 2 ms (host_sim/sim_poll_bench), the longer intervals miss the spin starts
+#define ENC_POLL_MIN_INTERVAL_US_DEFAULT  250
+#define ENC_POLL_MAX_INTERVAL_US_DEFAULT  2000
+#define ENC_POLL_PHASE_SAMPLES_DEFAULT    2
+
+// Adaptive polling back off delay - the average phase intervals number without the quarter steps
+#ifndef ENC_POLL_HOLD_PHASES
+#define ENC_POLL_HOLD_PHASES 4
+#endif
+
+// Events parameter index for the parameters outside of the bound parameters table
+#define ENC_PARAMETER_DIRECT 0xFF
+
 // =========================================================================================== DEFINES
 
 
@@ -30,6 +89,8 @@
 #include <my_libs/async_await/async_await.h> // Async await lib connection
 #include <my_libs/button_control/button_contol.h> // Button control lib connection
 
+#include "encoder_history.h" // Position history records
+
 // =========================================================================================== IMPORT
 
 
@@ -84,11 +145,221 @@ typedef enum {
     
 } rotation_overflow_mode;
 
+
+// Type: encoder_event_type
+// Purpose: Event types, which are generated by the encoder control functions for the subscribers and the events queue
+typedef enum {
+
+    ENC_EVENT_VALUE_CHANGED,    // Controlled parameter value has been changed by the rotation
+    ENC_EVENT_LIMIT_HIT,        // Rotation has pushed the parameter value to the limit with LIMITATION overflow mode
+    ENC_EVENT_WRAPPED,          // Parameter value has been moved to the other limit with ROTATION overflow mode
+    ENC_EVENT_SW_CLICK,         // SW-button click
+    ENC_EVENT_SW_DOUBLE_CLICK,  // SW-button double click (gesture engine)
+    ENC_EVENT_SW_LONG_PRESS,    // SW-button long press (gesture engine)
+    ENC_EVENT_PRESS_TURN,       // Rotation with the held SW-button - coarse step (gesture engine, delta - detents by the pins)
+    ENC_EVENT_HOMED,            // Homing has been finished by the index pulse
+    ENC_EVENT_INDEX_DRIFT,      // Counts per revolution mismatch at the index pulse (delta - drift counts)
+
+    ENC_EVENT_COUNT,            // Event types number (not an event)
+
+} encoder_event_type;
+
+
+// Type: encoder_decoder_mode
+// Purpose: Detent decoding logic of the encoder pins
+typedef enum {
+
+    ENC_DECODER_CLK_EDGE,             // Detent by the CLK rising edge with the DT direction and the debounce (default)
+    ENC_DECODER_QUADRATURE,           // Full (CLK, DT) state machine, one detent per 4 quarter steps, skipped states are dropped
+    ENC_DECODER_QUADRATURE_RECOVERY,  // Full state machine with the skipped state recovery by the recent direction and velocity
+
+} encoder_decoder_mode;
+
+
+// Type: encoder_homing_state
+// Purpose: Homing sequence state of the encoder with the index channel
+typedef enum {
+
+    ENC_HOMING_IDLE,  // No homing
+    ENC_HOMING_SEEK,  // Waiting of the index pulse
+    ENC_HOMING_DONE,  // Position has been referenced by the index pulse
+
+} encoder_homing_state;
+
+
+// Type: encoder_scan_backend
+// Purpose: I/O expanders scan bus backend for more encoders than native GPIOs
+typedef enum {
+
+    ENC_SCAN_SHIFT_REGISTER,  // Parallel-in shift registers chain (74HC165-style), bit-banged by the GPIO registers
+    ENC_SCAN_USER,            // User burst read function (I2C/SPI expanders, simulated expander)
+
+} encoder_scan_backend;
+
+
+// Type: encoder_scan_read_fn
+// Purpose: User burst read of all the expander lines into the buffer (line N - bit N % 8 of byte N / 8).
+// Shift registers backend lines are numbered in the shift order (see ENC_SCAN_SHIFT_REGISTER_LINE)
+typedef bool (*encoder_scan_read_fn)(void *user_data, uint8_t *buffer, size_t size);
+
 // =========================================================================================== TYPE DEFINITION SECTION
 
 
 // =========================================================================================== STRUCT DEFINITION SECTION
 
+// Struct: encoder_input_snapshot
+// Purpose: Stores the encoder pins states, taken by one input read per control call
+typedef struct encoder_input_snapshot
+{
+
+    bool clk; // CLK pin state
+    bool dt; // DT pin state
+    bool sw; // SW-button pressed state
+    bool z; // Index (Z) pin state
+
+} encoder_input_snapshot;
+
+
+// Struct: encoder_gesture_config
+// Purpose: Stores the timings of the gesture engine, which recognizes the SW-button gestures and press-and-turn
+// by the same input snapshot and time base, as the rotation
+typedef struct encoder_gesture_config
+{
+
+    uint32_t sw_debounce_us; // SW-button state stable time
+    uint32_t rotation_debounce_us; // Minimal time between the accepted detents
+    uint32_t double_click_us; // Second click waiting time (single click is reported after it)
+    uint32_t long_press_us; // SW-button hold time for the long press
+    uint16_t coarse_multiplier; // Step multiplier for the rotation with the held SW-button
+
+} encoder_gesture_config;
+
+
+// Struct: encoder_power_stats
+// Purpose: Stores the power accounting of the idle mode for the compare with the continuous polling
+typedef struct encoder_power_stats
+{
+
+    int64_t awake_us; // Time outside of the idle sleep (calculated by the encoder_power_stats_get function)
+    int64_t sleep_us; // Time inside the idle sleep
+    uint32_t polls; // Control calls number
+    uint32_t wakeups; // Idle sleep exits number
+    uint32_t last_exit_poll_delay_us; // Time from the last encoder wakeup (idle exit) to the first control call with the changed input.
+                                      // The caller loop delay only: the edge to decode latency also includes the light sleep
+                                      // exit before the encoder_idle_exit call, which is not seen by the encoder control
+    uint32_t max_exit_poll_delay_us; // Maximal idle exit to the first control call time
+
+} encoder_power_stats;
+
+
+// Struct: encoder_poll_config
+// Purpose: Stores the adaptive polling limits
+typedef struct encoder_poll_config
+{
+
+    uint32_t min_interval_us; // Fastest poll interval (rotation start and the fast spin)
+    uint32_t max_interval_us; // Slowest poll interval (idle encoder)
+    uint8_t phase_samples; // Polls per the average quadrature phase (quarter step interval of the decoder)
+
+} encoder_poll_config;
+
+
+// Struct: encoder_dirty_map
+// Purpose: Bank-wide bitmap of the changed parameters values (one bit per parameter) for the incremental redraw.
+// Shared by the encoders bank, each encoder uses its own base bit
+typedef struct encoder_dirty_map
+{
+
+    uint32_t words[ENC_DIRTY_MAP_WORDS]; // Dirty bits
+
+} encoder_dirty_map;
+
+
+// Struct: encoder_scan_bus
+// Purpose: Stores the scan bus of the I/O expanders with the last snapshot of all the lines.
+// The bus is read once per tick, then all the attached encoders are decoded from the snapshot
+typedef struct encoder_scan_bus
+{
+
+    encoder_scan_backend backend; // Bus backend
+    gpio_num_t load_pin; // Shift registers parallel load pin (PL, active low)
+    gpio_num_t clock_pin; // Shift registers clock pin (CP)
+    gpio_num_t data_pin; // Shift registers serial data pin (Q7)
+    encoder_scan_read_fn read; // User burst read function
+    void *user_data; // User read function data
+
+    uint16_t lines; // Bus lines number
+    uint16_t clocks_per_byte; // Bus clocks per 8 lines (8 - shift registers, 9 - I2C byte with ACK, 8 - SPI)
+    uint16_t frame_clocks; // Bus clocks per burst outside of the lines data (load pulse, I2C address/register/start/stop)
+    uint32_t burst_clocks; // Bus clocks per burst (frame + lines data) for the capacity calculation
+    uint8_t snapshot[ENC_SCAN_BUS_BYTES]; // Last burst lines states
+    uint32_t scans; // Successful bursts number
+    uint32_t scan_errors; // Failed bursts number
+
+} encoder_scan_bus;
+
+
+// Struct: encoder_scan_capacity
+// Purpose: Stores the scan bus capacity at the selected scan clock
+typedef struct encoder_scan_capacity
+{
+
+    uint32_t burst_ns; // One burst time
+    uint32_t max_scan_rate_hz; // Bursts per second with the continuous scan
+    uint32_t max_detent_rate_hz; // Sustainable detents per second per encoder for the quadrature decoders (4 snapshots per period)
+    uint32_t max_detent_rate_clk_edge_hz; // Same for the default CLK edge decoder - limited by its debounce (ENC_CLK_EDGE_DEBOUNCE_MS)
+    uint16_t max_encoders; // Bus limit: encoders number, scanned fast enough for the target detent rate (quadrature decoders;
+                           // the CLK edge decoder can't follow the target above max_detent_rate_clk_edge_hz at any encoders number)
+    uint16_t max_encoders_buffer; // Buffer limit: encoders number inside the snapshot (ENC_SCAN_BUS_MAX_LINES)
+
+} encoder_scan_capacity;
+
+
+// Struct: encoder_parameter
+// Purpose: Stores one encoder controlled parameter with the already converted regulation values.
+// Used by the enc_rotation_value_control function as the cache and as the entry of the encoder parameters table
+typedef struct encoder_parameter
+{
+
+    void *link; // Link to the controlled variable (&parameter)
+    parameter_type type; // Parameter type
+    rotation_side side; // Rotation side influence on the parameter value
+    rotation_overflow_mode overflow_mode; // Overflow mode
+
+    parameter_value_union parameter; // Cached parameter value
+    parameter_value_union step; // Regulation step
+    parameter_value_union min_val; // Minimum parameter value
+    parameter_value_union max_val; // Maximum parameter value
+
+    const parameter_value_union *lut; // Values table for the index mapping (NULL - linear stepping by the step value)
+    uint16_t lut_size; // Number of the table values
+    uint16_t lut_index; // Current table index, moved by the rotation
+
+} encoder_parameter;
+
+
+// Struct: encoder_event
+// Purpose: Stores the encoder event data. The events of the same type and parameter, which were generated between
+// the consumer runs, are coalesced into one event with the net delta and the final value
+typedef struct encoder_event
+{
+
+    encoder_event_type type; // Event type
+    const struct encoder_parameter *parameter; // Source parameter (NULL - before the first control call)
+    uint8_t parameter_index; // Index of the parameter inside the bound table (ENC_PARAMETER_DIRECT for the other parameters)
+    int32_t delta; // Net detents for the value events (+ for the increase, - for the decrease), clicks number for the SW events
+    parameter_type value_type; // Type of the value below
+    parameter_value_union value; // Final parameter value
+
+} encoder_event;
+
+
+// Type: encoder_event_callback
+// Purpose: Subscriber function, called by the encoder_events_dispatch function for the subscribed event type
+struct encoder_ctx;
+typedef void (*encoder_event_callback)(struct encoder_ctx *encoder, const encoder_event *event, void *user_data);
+
+
 // Struct: encoder_ctx
 // Purpose: Stores the pin numbers and debounce delay context for the encoder control
 typedef struct encoder_ctx
@@ -99,22 +370,89 @@ typedef struct encoder_ctx
     gpio_num_t ENC_SW; // SW pin
     gpio_num_t ENC_DT; // DT pin
     gpio_num_t ENC_CLK; // CLK pin
+    gpio_num_t ENC_Z; // Index (Z) pin (optional, set by the encoder_index_setup function)
 
     async_await_ctx ENC_AWAIT; // Async await context
     
     button_ctx sw_button; // SW button ctx by button_control library
 
-    rotation_overflow_mode overflow_mode; // Overflow mode
-
     bool last_clk_state; // Last CLK pin state for the parameter control
     // Flag for the correct call of the par_type_converting function inside the enc_rotation_value_control function
     bool new_parameter_type;
     
-    parameter_type controlled_parameter_type; // Holder for the current parameter type
-    parameter_value_union parameter; // Curr type from value union
-    parameter_value_union step; // Regulation step
-    parameter_value_union min_val; // Minimum parameter value
-    parameter_value_union max_val; // Maximum parameter value
+    encoder_parameter direct_parameter; // Parameter storage for the enc_rotation_value_control function
+    encoder_parameter *active_parameter; // Last controlled parameter (events values source)
+
+    encoder_parameter *parameter_table; // Bound parameters table (NULL - no table)
+    uint8_t parameter_count; // Number of the table entries
+    uint8_t active_index; // Index of the active table entry
+    bool sw_table_switch; // Active table entry switch by the SW-button click
+
+    bool gestures_enabled; // Gesture engine enable flag
+    encoder_gesture_config gesture_config; // Gesture engine timings
+    int64_t last_detent_us; // Last accepted detent time for the rotation debounce
+    bool sw_raw_state; // Last raw SW-button state
+    int64_t sw_raw_change_us; // Last raw SW-button state change time
+    bool sw_pressed; // Debounced SW-button state
+    int64_t sw_press_us; // SW-button press time
+    int64_t sw_release_us; // SW-button release time
+    uint8_t sw_clicks; // Clicks inside the double click window
+    bool sw_long_sent; // Long press has been reported for the current hold
+    bool sw_turned; // Rotation has been made with the current hold
+
+    encoder_input_snapshot last_input; // Last input snapshot for the activity fix and the wakeup levels
+    int64_t last_activity_us; // Last input change time
+    uint32_t idle_quiet_us; // Quiet period before the idle mode (0 - idle mode disabled)
+    bool idle_armed; // Edge wakeups are armed
+    int64_t idle_enter_us; // Idle sleep start time
+    int64_t idle_exit_us; // Idle sleep end time
+    bool exit_poll_pending; // Waiting of the first control call after the idle exit
+    encoder_power_stats power_stats; // Power accounting
+    int64_t power_stats_start_us; // Power accounting start time
+
+    int32_t position; // Absolute position in detents (+ for the DT differs from CLK rotation)
+    uint32_t counts_per_rev; // Detents per revolution for the index check (0 - no check)
+    bool index_correction; // Position correction by the index drift
+    int8_t index_direction; // Last quarter step direction by the pins - the index crossing direction (0 - unknown)
+    bool index_latched[2]; // Index reference positions are set by the crossing direction ([0] - positive, [1] - negative)
+    int32_t index_position[2]; // Positions at the last index pulses by the crossing direction
+    uint32_t index_pulses; // Index pulses number
+    int32_t last_drift; // Last index drift (counts)
+    uint32_t drift_events; // Index pulses with the drift
+    uint32_t drift_corrected; // Total corrected counts
+    encoder_homing_state homing_state; // Homing sequence state
+    int32_t home_position; // Position value, set by the homing
+
+    encoder_history *history; // Position history (NULL - no history)
+
+    encoder_dirty_map *dirty_map; // Bank dirty bitmap (NULL - no dirty bits)
+    uint16_t dirty_base_bit; // First bit of the encoder parameters inside the bitmap
+
+    encoder_scan_bus *scan_bus; // Scan bus of the scanned encoder (NULL - native GPIO pins)
+
+    encoder_decoder_mode decoder_mode; // Detent decoder
+    uint8_t quad_state; // Last (CLK, DT) state of the quarter steps tracking (all the decoders)
+    int8_t quad_steps; // Quarter steps accumulator
+    int8_t last_step_direction; // Last quarter step direction (0 - unknown)
+    int64_t last_step_us; // Last quarter step time
+    uint8_t idle_polls; // Control calls without the state change after the last quarter step
+    uint32_t step_interval_us; // Average quarter step interval (recent velocity, all the decoders)
+    uint32_t last_interval_us; // Last quarter step interval sample of the average
+    uint32_t recovered_steps; // Skipped states, recovered by the recent direction
+    uint32_t ambiguous_steps; // Skipped states, dropped or taken from the pins without the direction
+
+    bool poll_enabled; // Adaptive polling is enabled
+    encoder_poll_config poll_config; // Adaptive polling limits
+    uint32_t poll_interval_us; // Current recommended poll interval
+    int64_t next_poll_us; // Recommended next poll deadline
+
+    encoder_event_callback callbacks[ENC_EVENT_COUNT]; // Subscribers by the event type
+    void *callbacks_user_data[ENC_EVENT_COUNT]; // Subscribers user data by the event type
+
+    encoder_event event_queue[ENC_EVENT_QUEUE_SIZE]; // Bounded events queue (ring buffer)
+    uint8_t event_head; // Index of the oldest event inside the queue
+    uint8_t event_count; // Number of the pending events inside the queue
+    uint16_t events_dropped; // Number of the events, dropped with the full queue
 
 } encoder_ctx;
 
@@ -123,6 +461,10 @@ typedef struct encoder_ctx
 
 // =========================================================================================== API DECLARATION
 
+// E12 preferred numbers series (values * 100)
+extern const uint16_t ENC_E12_SERIES[12];
+
+
 // Function: encoder_ctx_default
 // Purpose: Default encoder_ctx struct initializer macros for initialization function
 static inline encoder_ctx encoder_ctx_default(void) {
@@ -133,15 +475,100 @@ static inline encoder_ctx encoder_ctx_default(void) {
         .ENC_SW = GPIO_PIN_NONE,
         .ENC_DT = GPIO_PIN_NONE,
         .ENC_CLK = GPIO_PIN_NONE,
+        .ENC_Z = GPIO_PIN_NONE,
         .ENC_AWAIT = {0},
-        .overflow_mode = LIMITATION,
         .last_clk_state = false,
         .new_parameter_type = true,
-        .controlled_parameter_type = TYPE_FLOAT,
-        .parameter = {0},
-        .step = {0},
-        .min_val = {0},
-        .max_val = {0},
+        .direct_parameter = { .link = NULL, .type = TYPE_FLOAT, .side = CLOCKWISE, .overflow_mode = LIMITATION, .lut = NULL },
+        .active_parameter = NULL,
+        .parameter_table = NULL,
+        .parameter_count = 0,
+        .active_index = 0,
+        .sw_table_switch = false,
+        .gestures_enabled = false,
+        .gesture_config = {0},
+        .last_detent_us = 0,
+        .sw_raw_state = false,
+        .sw_raw_change_us = 0,
+        .sw_pressed = false,
+        .sw_press_us = 0,
+        .sw_release_us = 0,
+        .sw_clicks = 0,
+        .sw_long_sent = false,
+        .sw_turned = false,
+        .last_input = {0},
+        .last_activity_us = 0,
+        .idle_quiet_us = 0,
+        .idle_armed = false,
+        .idle_enter_us = 0,
+        .idle_exit_us = 0,
+        .exit_poll_pending = false,
+        .power_stats = {0},
+        .power_stats_start_us = 0,
+        .position = 0,
+        .counts_per_rev = 0,
+        .index_correction = false,
+        .index_direction = 0,
+        .index_latched = {false, false},
+        .index_position = {0, 0},
+        .index_pulses = 0,
+        .last_drift = 0,
+        .drift_events = 0,
+        .drift_corrected = 0,
+        .homing_state = ENC_HOMING_IDLE,
+        .home_position = 0,
+        .history = NULL,
+        .dirty_map = NULL,
+        .dirty_base_bit = 0,
+        .scan_bus = NULL,
+        .decoder_mode = ENC_DECODER_CLK_EDGE,
+        .quad_state = 0,
+        .quad_steps = 0,
+        .last_step_direction = 0,
+        .last_step_us = 0,
+        .idle_polls = 0,
+        .step_interval_us = 0,
+        .last_interval_us = 0,
+        .recovered_steps = 0,
+        .ambiguous_steps = 0,
+        .poll_enabled = false,
+        .poll_config = {0},
+        .poll_interval_us = 0,
+        .next_poll_us = 0,
+        .callbacks = {0},
+        .callbacks_user_data = {0},
+        .event_queue = {{0}},
+        .event_head = 0,
+        .event_count = 0,
+        .events_dropped = 0,
+
+    };
+}
+
+
+// Function: encoder_gesture_config_default
+// Purpose: Default gesture engine configuration
+static inline encoder_gesture_config encoder_gesture_config_default(void) {
+    return (encoder_gesture_config){
+
+        .sw_debounce_us = ENC_GESTURE_SW_DEBOUNCE_US_DEFAULT,
+        .rotation_debounce_us = ENC_GESTURE_ROTATION_DEBOUNCE_US_DEFAULT,
+        .double_click_us = ENC_GESTURE_DOUBLE_CLICK_US_DEFAULT,
+        .long_press_us = ENC_GESTURE_LONG_PRESS_US_DEFAULT,
+        .coarse_multiplier = ENC_GESTURE_COARSE_MULTIPLIER_DEFAULT,
+
+    };
+}
+
+
+// Function: encoder_poll_config_default
+// Purpose: Default adaptive polling configuration
+static inline encoder_poll_config encoder_poll_config_default(void) {
+    return (encoder_poll_config){
+
+        .min_interval_us = ENC_POLL_MIN_INTERVAL_US_DEFAULT,
+        .max_interval_us = ENC_POLL_MAX_INTERVAL_US_DEFAULT,
+        .phase_samples = ENC_POLL_PHASE_SAMPLES_DEFAULT,
 
     };
 }
@@ -181,6 +608,228 @@ void enc_rotation_value_control(
 );
 
 
+// Function: encoder_gesture_setup
+// Purpose: Enable the gesture engine with the selected configuration (NULL - default configuration).
+// SW, CLK and DT are read together once per control call: clicks, double clicks, long presses and
+// press-and-turn (coarse step) are reported as the events, the SW-button click switches the table entries
+void encoder_gesture_setup(encoder_ctx *encoder, const encoder_gesture_config *config);
+
+
+// Function: encoder_idle_setup
+// Purpose: Set the quiet period (without the input changes) for the idle mode (0 - idle mode disable)
+void encoder_idle_setup(encoder_ctx *encoder, uint32_t quiet_us);
+
+
+// Function: encoder_idle_ready
+// Purpose: Checks if the quiet period has passed, and the caller can arm the wakeups and sleep
+bool encoder_idle_ready(encoder_ctx *encoder);
+
+
+// Function: encoder_idle_enter
+// Purpose: Arm the CLK/DT/SW edge wakeups for the light sleep (the caller starts the sleep by itself)
+void encoder_idle_enter(encoder_ctx *encoder);
+
+
+// Function: encoder_idle_exit
+// Purpose: Disarm the wakeups after the sleep. The decoding resumes from the last states, so the first detent is not lost
+void encoder_idle_exit(encoder_ctx *encoder);
+
+
+// Function: encoder_power_stats_get
+// Purpose: Get the power accounting statistics (awake/sleep time, polls, wakeups and the idle exit to the first poll time)
+void encoder_power_stats_get(encoder_ctx *encoder, encoder_power_stats *stats);
+
+
+// Function: encoder_power_stats_reset
+// Purpose: Reset the power accounting statistics
+void encoder_power_stats_reset(encoder_ctx *encoder);
+
+
+// Function: encoder_power_duty_cycle_permille
+// Purpose: Awake time part of the statistics time in per mille (1000 for the continuous polling)
+uint16_t encoder_power_duty_cycle_permille(const encoder_power_stats *stats);
+
+
+// Function: encoder_power_continuous_polls
+// Purpose: Control calls number of the continuous polling with the selected period for the statistics time (compare with the polls)
+uint32_t encoder_power_continuous_polls(const encoder_power_stats *stats, uint32_t poll_period_us);
+
+
+// Function: enc_parameter_rotation_control
+// Purpose: Control the cached parameter by the encoder rotation with the parameter side and overflow mode.
+// The external change of the controlled variable is reloaded into the cache
+void enc_parameter_rotation_control(encoder_ctx *encoder, encoder_parameter *par);
+
+
+// Function: enc_position_control
+// Purpose: Control the absolute encoder position (rotary-sensor use) without the controlled parameter.
+// Returns the detent direction (+1 - DT differs from CLK at the CLK rising, -1 - equal, 0 - no detent)
+int8_t enc_position_control(encoder_ctx *encoder);
+
+
+// Function: encoder_index_setup
+// Purpose: Set the index (Z) pin with the counts per revolution check (0 - no check) at each index pulse.
+// The position at the index pulse differs by one count for the opposite crossing directions, so each pulse is checked
+// against the last pulse of the same direction. correction - return the position to the index reference by the found drift
+void encoder_index_setup(encoder_ctx *encoder, gpio_num_t z_pin, uint32_t counts_per_rev, bool correction);
+
+
+// Function: encoder_homing_start
+// Purpose: Start the homing sequence - the position is set to home_position by the next index pulse
+void encoder_homing_start(encoder_ctx *encoder, int32_t home_position);
+
+
+// Function: encoder_is_homed
+// Purpose: Checks if the homing sequence has been finished
+bool encoder_is_homed(const encoder_ctx *encoder);
+
+
+// Function: encoder_history_attach
+// Purpose: Attach the initialized position history to the encoder - each position change is added as the
+// (time, position) record (NULL - history detach)
+void encoder_history_attach(encoder_ctx *encoder, encoder_history *history);
+
+
+// Function: encoder_dirty_attach
+// Purpose: Attach the bank dirty bitmap to the encoder. The bit is set only by the real value change:
+// table entries use base_bit + entry index, the other parameters use base_bit (NULL map - detach)
+void encoder_dirty_attach(encoder_ctx *encoder, encoder_dirty_map *map, uint16_t base_bit);
+
+
+// Function: encoder_dirty_set
+// Purpose: Set the dirty bit atomically (as like for the external value change)
+void encoder_dirty_set(encoder_dirty_map *map, uint16_t bit);
+
+
+// Function: encoder_dirty_next
+// Purpose: Take the first set bit with the atomic clear. Returns the bit index, or -1 if there are no set bits
+int encoder_dirty_next(encoder_dirty_map *map);
+
+
+// Function: encoder_dirty_any
+// Purpose: Checks if any bit is set
+bool encoder_dirty_any(const encoder_dirty_map *map);
+
+
+// Function: encoder_scan_bus_shift_register_init
+// Purpose: Initialize the scan bus of the parallel-in shift registers chain (74HC165-style). All three pins are required.
+// Line 0 is the H (D7) input of the chip nearest to the MCU, line 7 - its A (D0), line 8 - H of the next chip
+// (see ENC_SCAN_SHIFT_REGISTER_LINE)
+void encoder_scan_bus_shift_register_init(encoder_scan_bus *bus, gpio_num_t load_pin, gpio_num_t clock_pin, gpio_num_t data_pin, uint16_t lines);
+
+
+// Function: encoder_scan_bus_user_init
+// Purpose: Initialize the scan bus with the user burst read function (I2C/SPI expanders or the simulated expander).
+// Bus timing for the capacity calculation: clocks_per_byte - clocks per 8 lines (9 for I2C with ACK, 8 for SPI),
+// frame_clocks - clocks per burst outside of the data (I2C start, address and register bytes, restart, stop)
+void encoder_scan_bus_user_init(encoder_scan_bus *bus, encoder_scan_read_fn read, void *user_data, uint16_t lines,
+    uint16_t clocks_per_byte, uint16_t frame_clocks);
+
+
+// Function: encoder_scan_bus_read
+// Purpose: Read all the bus lines by one burst (once per tick, before the attached encoders control)
+bool encoder_scan_bus_read(encoder_scan_bus *bus);
+
+
+// Function: encoder_scan_attach
+// Purpose: Attach the encoder to the scan bus - the SW/DT/CLK pins are replaced by the bus lines.
+// Scanned encoders use the gesture engine for the SW-button and don't support the idle mode wakeups
+void encoder_scan_attach(encoder_ctx *encoder, encoder_scan_bus *bus, gpio_num_t sw_line, gpio_num_t dt_line, gpio_num_t clk_line);
+
+
+// Function: encoder_scan_bus_capacity
+// Purpose: Calculate the scan bus capacity at the selected scan clock: burst time, maximal detent rate per encoder
+// and the maximal encoders number for the target detent rate - by the bus timing and by the snapshot buffer separately.
+// The detent rate and the bus limit are given for the quadrature decoders (encoder_decoder_setup), the default CLK edge
+// decoder is limited by its debounce (max_detent_rate_clk_edge_hz)
+void encoder_scan_bus_capacity(const encoder_scan_bus *bus, uint32_t scan_clock_hz, uint8_t lines_per_encoder,
+    uint32_t target_detent_rate_hz, encoder_scan_capacity *capacity);
+
+
+// Function: encoder_decoder_setup
+// Purpose: Select the detent decoder. The recovery decoder infers the skipped (CLK, DT) state of the late poll by
+// the recent direction and velocity (recovered_steps), the not inferred states are dropped (ambiguous_steps)
+void encoder_decoder_setup(encoder_ctx *encoder, encoder_decoder_mode mode);
+
+
+// Function: encoder_poll_setup
+// Purpose: Enable the adaptive polling with the selected configuration (NULL - default configuration).
+// The poll interval follows the quarter step interval of the decoder (the same velocity estimate as for the skipped
+// states recovery), drops to the minimal one at the rotation start and doubles up to the maximal one after the rotation stop
+void encoder_poll_setup(encoder_ctx *encoder, const encoder_poll_config *config);
+
+
+// Function: encoder_next_poll_us
+// Purpose: Recommended next control call time (esp_timer time base). Without the adaptive polling - now
+int64_t encoder_next_poll_us(const encoder_ctx *encoder);
+
+
+// Function: encoder_bank_next_poll_us
+// Purpose: Recommended next control call time for the encoders bank (the earliest deadline of the encoders)
+int64_t encoder_bank_next_poll_us(const encoder_ctx *encoders, size_t count);
+
+
+// Function: encoder_parameter_lut_setup
+// Purpose: Switch the parameter to the index mapping - the rotation moves the table index with the parameter overflow mode,
+// and the value is taken from the precomputed table (NULL table - linear stepping return)
+void encoder_parameter_lut_setup(encoder_parameter *par, const parameter_value_union *lut, uint16_t size, uint16_t start_index);
+
+
+// Function: encoder_lut_log_fill
+// Purpose: Fill the values table by the logarithmic scale from min_val to max_val (initialization time calculations)
+void encoder_lut_log_fill(parameter_value_union *lut, uint16_t size, parameter_type type, float min_val, float max_val);
+
+
+// Function: encoder_lut_series_fill
+// Purpose: Fill the values table by the preferred numbers series (as like ENC_E12_SERIES) decade by decade,
+// starting from the series values * first_multiplier
+void encoder_lut_series_fill(parameter_value_union *lut, uint16_t size, parameter_type type,
+    const uint16_t *series, uint8_t series_len, float first_multiplier);
+
+
+// Function: encoder_parameter_table_bind
+// Purpose: Bind the static parameters table to the encoder. Entries values are converted once here.
+// sw_switch - active entry switch to the next one by the SW-button click
+void encoder_parameter_table_bind(encoder_ctx *encoder, encoder_parameter *table, uint8_t count, bool sw_switch);
+
+
+// Function: encoder_parameter_select
+// Purpose: Switch the active table entry by index (pointer update only)
+void encoder_parameter_select(encoder_ctx *encoder, uint8_t index);
+
+
+// Function: encoder_parameter_next
+// Purpose: Switch the active table entry to the next one (first one after the last)
+void encoder_parameter_next(encoder_ctx *encoder);
+
+
+// Function: enc_table_rotation_control
+// Purpose: Control the active table entry by the encoder rotation with the SW-button entries switch
+void enc_table_rotation_control(encoder_ctx *encoder);
+
+
+// Function: enc_sw_click_control
+// Purpose: Control the encoder SW-button clicks by the button_control library with the ENC_EVENT_SW_CLICK events generation
+// (no effect with the gesture engine - it reports the SW clicks by itself)
+void enc_sw_click_control(encoder_ctx *encoder);
+
+
+// Function: encoder_event_subscribe
+// Purpose: Set the subscriber function for the selected event type (NULL callback for the unsubscribe)
+void encoder_event_subscribe(encoder_ctx *encoder, encoder_event_type type, encoder_event_callback callback, void *user_data);
+
+
+// Function: encoder_event_pop
+// Purpose: Take the oldest pending event from the encoder events queue. Returns false if the queue is empty
+bool encoder_event_pop(encoder_ctx *encoder, encoder_event *event);
+
+
+// Function: encoder_events_dispatch
+// Purpose: Take all the pending events from the queue and call the subscribers for them.
+// Returns the number of the events taken from the queue
+uint8_t encoder_events_dispatch(encoder_ctx *encoder);
+
+
 // Helper-function: par_type_converting
 // Purpose: Translate the parameters for the current value control function by the selected data and parameter 
 void par_type_converting(encoder_ctx *encoder, parameter_type type, void *parameter, void *step, void *min_val, void *max_val);
@@ -0,0 +1,353 @@
+// =========================================================================================== INFO
+
+// Encoder position history (main File, C version)
+// Author: dimakomplekt
+// Description: Delta-encoded (timestamp, position) records ring for the motion analysis, using pure C.
+// Record: time delta (unsigned varint, microseconds) + position delta (zigzag varint).
+// The same decoder works on the device (ring buffer) and on the host (exported linear buffer)
+
+// =========================================================================================== INFO
+
+
+// =========================================================================================== IMPORT
+
+// Header import
+#include "encoder_history.h"
+
+// =========================================================================================== IMPORT
+
+
+// =========================================================================================== HELPER FUNCTIONS
+
+// Unsigned varint write (7 bits per byte, high bit - next byte flag). Returns the written bytes number
+static size_t hist_varint_write(uint8_t *out, uint64_t value)
+{
+    size_t length = 0;
+
+    while (value >= 0x80)
+    {
+        out[length++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+
+    out[length++] = (uint8_t)value;
+
+    return length;
+}
+
+
+// Unsigned varint read from the ring or linear buffer (offsets are taken by modulo of the buffer size)
+static bool hist_varint_read(const uint8_t *buffer, size_t size, size_t *offset, size_t end, uint64_t *value)
+{
+    uint64_t result = 0;
+    unsigned shift = 0;
+
+    while (*offset < end && shift < 64)
+    {
+        uint8_t byte = buffer[*offset % size];
+        (*offset)++;
+
+        result |= (uint64_t)(byte & 0x7F) << shift;
+
+        // Last byte of the value
+        if (!(byte & 0x80))
+        {
+            *value = result;
+            return true;
+        }
+
+        shift += 7;
+    }
+
+    // Broken or cut value
+    return false;
+}
+
+
+// Signed value converting for the short varint of the small negative values: 0, -1, 1, -2 ... -> 0, 1, 2, 3 ...
+static inline uint32_t hist_zigzag_encode(int32_t value)
+{
+    return (value < 0) ? ~((uint32_t)value << 1) : ((uint32_t)value << 1);
+}
+
+
+static inline int32_t hist_zigzag_decode(uint32_t value)
+{
+    return (int32_t)((value >> 1) ^ (~(value & 1) + 1));
+}
+
+
+// One record read with the time and position deltas
+static bool hist_record_read(const uint8_t *buffer, size_t size, size_t *offset, size_t end, uint64_t *time_delta, int32_t *position_delta)
+{
+    uint64_t zigzag;
+
+    if (!hist_varint_read(buffer, size, offset, end, time_delta)) return false;
+    if (!hist_varint_read(buffer, size, offset, end, &zigzag) || zigzag > UINT32_MAX) return false;
+
+    *position_delta = hist_zigzag_decode((uint32_t)zigzag);
+
+    return true;
+}
+
+
+// Oldest record drop with the base values move
+static void hist_drop_oldest(encoder_history *history)
+{
+    size_t offset = history->head;
+    uint64_t time_delta;
+    int32_t position_delta;
+
+    // Broken data error handler - full clear instead of the endless drop
+    if (!hist_record_read(history->buffer, history->size, &offset, history->head + history->used, &time_delta, &position_delta))
+    {
+        encoder_history_clear(history);
+        return;
+    }
+
+    history->base_time_us += (int64_t)time_delta;
+    history->base_position = (int32_t)((uint32_t)history->base_position + (uint32_t)position_delta);
+
+    history->used -= offset - history->head;
+    history->head = offset % history->size;
+    history->records--;
+    history->dropped_records++;
+}
+
+// =========================================================================================== HELPER FUNCTIONS
+
+
+// =========================================================================================== API DEFINITION SECTION
+
+// History initialization by the user storage
+void encoder_history_init(encoder_history *history, uint8_t *buffer, size_t size)
+{
+    // Error handler
+    if (!history) return;
+
+    history->buffer = buffer;
+    history->size = buffer ? size : 0;
+    history->dropped_records = 0;
+
+    encoder_history_clear(history);
+}
+
+
+// All records removing
+void encoder_history_clear(encoder_history *history)
+{
+    // Error handler
+    if (!history) return;
+
+    history->head = 0;
+    history->used = 0;
+    history->records = 0;
+    history->base_time_us = 0;
+    history->base_position = 0;
+    history->last_time_us = 0;
+    history->last_position = 0;
+    history->started = false;
+}
+
+
+// New sample adding as the delta record from the newest one
+bool encoder_history_append(encoder_history *history, int64_t time_us, int32_t position)
+{
+    // Error handler
+    if (!history || !history->buffer || history->size == 0) return false;
+
+    // First sample - base values (the first record has the zero deltas)
+    if (!history->started)
+    {
+        history->base_time_us = time_us;
+        history->base_position = position;
+        history->last_time_us = time_us;
+        history->last_position = position;
+        history->started = true;
+    }
+
+    // Record encoding
+    uint8_t record[ENC_HISTORY_RECORD_MAX_SIZE];
+    uint64_t time_delta = (time_us > history->last_time_us) ? (uint64_t)(time_us - history->last_time_us) : 0;
+    int32_t position_delta = (int32_t)((uint32_t)position - (uint32_t)history->last_position);
+
+    size_t length = hist_varint_write(record, time_delta);
+    length += hist_varint_write(&record[length], hist_zigzag_encode(position_delta));
+
+    // Storage error handler
+    if (length > history->size) return false;
+
+    // Free space for the new record by the oldest records drop
+    while (history->size - history->used < length) hist_drop_oldest(history);
+
+    // Ring write
+    for (size_t i = 0; i < length; i++)
+    {
+        history->buffer[(history->head + history->used) % history->size] = record[i];
+        history->used++;
+    }
+
+    history->records++;
+    history->last_time_us = history->last_time_us + (int64_t)time_delta;
+    history->last_position = position;
+
+    return true;
+}
+
+
+// Iteration start from the oldest record of the ring
+void encoder_history_iter_begin(const encoder_history *history, encoder_history_iter *iter)
+{
+    // Error handler
+    if (!iter) return;
+
+    *iter = (encoder_history_iter){0};
+
+    if (!history || !history->buffer || history->size == 0) return;
+
+    iter->buffer = history->buffer;
+    iter->size = history->size;
+    iter->offset = history->head;
+    iter->end = history->head + history->used;
+    iter->remaining = history->records;
+    iter->time_us = history->base_time_us;
+    iter->position = history->base_position;
+}
+
+
+// Next sample decoding
+bool encoder_history_iter_next(encoder_history_iter *iter, encoder_history_sample *sample)
+{
+    // Error handler
+    if (!iter || !sample || iter->remaining == 0) return false;
+
+    uint64_t time_delta;
+    int32_t position_delta;
+
+    if (!hist_record_read(iter->buffer, iter->size, &iter->offset, iter->end, &time_delta, &position_delta))
+    {
+        iter->remaining = 0;
+        return false;
+    }
+
+    iter->time_us += (int64_t)time_delta;
+    iter->position = (int32_t)((uint32_t)iter->position + (uint32_t)position_delta);
+    iter->remaining--;
+
+    sample->time_us = iter->time_us;
+    sample->position = iter->position;
+
+    return true;
+}
+
+
+// Linear copy with the header for the host-side decoder
+size_t encoder_history_export(const encoder_history *history, uint8_t *out, size_t out_size)
+{
+    // Error handler
+    if (!history || !out) return 0;
+
+    // Header
+    uint8_t header[ENC_HISTORY_EXPORT_HEADER_MAX_SIZE];
+    size_t length = 0;
+
+    header[length++] = ENC_HISTORY_EXPORT_MAGIC_0;
+    header[length++] = ENC_HISTORY_EXPORT_MAGIC_1;
+    header[length++] = ENC_HISTORY_EXPORT_VERSION;
+    length += hist_varint_write(&header[length], (uint64_t)history->base_time_us);
+    length += hist_varint_write(&header[length], hist_zigzag_encode(history->base_position));
+    length += hist_varint_write(&header[length], history->records);
+
+    // Output size error handler
+    if (out_size < length + history->used) return 0;
+
+    for (size_t i = 0; i < length; i++) out[i] = header[i];
+
+    // Ring records linearization
+    for (size_t i = 0; i < history->used; i++) out[length + i] = history->buffer[(history->head + i) % history->size];
+
+    return length + history->used;
+}
+
+
+// Exported data header parse with the iterator start
+bool encoder_history_decode_begin(const uint8_t *data, size_t size, encoder_history_iter *iter)
+{
+    // Error handler
+    if (!data || !iter || size < 3) return false;
+
+    *iter = (encoder_history_iter){0};
+
+    if (data[0] != ENC_HISTORY_EXPORT_MAGIC_0 || data[1] != ENC_HISTORY_EXPORT_MAGIC_1 || data[2] != ENC_HISTORY_EXPORT_VERSION) return false;
+
+    size_t offset = 3;
+    uint64_t base_time, base_position, records;
+
+    if (!hist_varint_read(data, size, &offset, size, &base_time)) return false;
+    if (!hist_varint_read(data, size, &offset, size, &base_position) || base_position > UINT32_MAX) return false;
+    if (!hist_varint_read(data, size, &offset, size, &records) || records > UINT32_MAX) return false;
+
+    iter->buffer = data;
+    iter->size = size;
+    iter->offset = offset;
+    iter->end = size;
+    iter->remaining = (uint32_t)records;
+    iter->time_us = (int64_t)base_time;
+    iter->position = hist_zigzag_decode((uint32_t)base_position);
+
+    return true;
+}
+
+// =========================================================================================== API DEFINITION SECTION
+
+
+// =========================================================================================== USING EXAMPLE SECTION
+
+/*
+
+#include <my_libs/encoder_control/encoder_control.h>
+
+encoder_ctx encoder;
+
+// 2 KB of the motion history
+static uint8_t history_storage[2048];
+encoder_history history;
+
+void app_main() {
+    encoder_initialization(&encoder, GPIO_PIN_NONE, GPIO_PIN_NONE, GPIO_PIN_NONE, GPIO_NUM_12, GPIO_NUM_14);
+
+    encoder_history_init(&history, history_storage, sizeof(history_storage));
+    encoder_history_attach(&encoder, &history);
+
+    while (1)
+    {
+        enc_position_control(&encoder);
+        await(500, TIME_UNIT_US);
+    }
+}
+
+// Motion profile output
+void history_print(void) {
+    encoder_history_iter iter;
+    encoder_history_sample sample;
+
+    encoder_history_iter_begin(&history, &iter);
+
+    while (encoder_history_iter_next(&iter, &sample))
+        printf("%lld us: %ld\n", sample.time_us, sample.position);
+}
+
+// Host side: the same encoder_history.c, data from encoder_history_export
+void host_decode(const uint8_t *data, size_t size) {
+    encoder_history_iter iter;
+    encoder_history_sample sample;
+
+    if (!encoder_history_decode_begin(data, size, &iter)) return;
+
+    while (encoder_history_iter_next(&iter, &sample))
+        printf("%lld,%d\n", (long long)sample.time_us, sample.position);
+}
+
+*/
+
+// =========================================================================================== USING EXAMPLE SECTION
@@ -0,0 +1,130 @@
+// =========================================================================================== INFO
+
+// Encoder position history (Header File, C version)
+// Author: dimakomplekt
+// Description: Bounded in-RAM history of the encoder (timestamp, position) samples, stored as the variable-length
+// delta-encoded records, with the streaming iterator and the host-side decoder. Pure C without the platform dependencies
+
+// =========================================================================================== INFO
+
+
+// =========================================================================================== DEFINES
+
+#ifndef ENCODER_HISTORY_H
+#define ENCODER_HISTORY_H
+
+// Maximal record size: time delta varint (10 bytes) + position delta zigzag varint (5 bytes)
+#define ENC_HISTORY_RECORD_MAX_SIZE 15
+
+// Export header: magic (2 bytes) + version + base time varint + base position varint + records number varint
+#define ENC_HISTORY_EXPORT_MAGIC_0  'E'
+#define ENC_HISTORY_EXPORT_MAGIC_1  'H'
+#define ENC_HISTORY_EXPORT_VERSION  1
+#define ENC_HISTORY_EXPORT_HEADER_MAX_SIZE (3 + 10 + 5 + 5)
+
+// =========================================================================================== DEFINES
+
+
+// =========================================================================================== IMPORT
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// =========================================================================================== IMPORT
+
+
+// =========================================================================================== STRUCT DEFINITION SECTION
+
+// Struct: encoder_history_sample
+// Purpose: Stores one decoded history sample
+typedef struct encoder_history_sample
+{
+
+    int64_t time_us; // Sample time (microseconds)
+    int32_t position; // Encoder position
+
+} encoder_history_sample;
+
+
+// Struct: encoder_history
+// Purpose: Stores the ring buffer of the delta-encoded records with the base values before the oldest record.
+// The oldest records are dropped for the new ones with the full buffer
+typedef struct encoder_history
+{
+
+    uint8_t *buffer; // Records storage (user memory)
+    size_t size; // Storage size
+    size_t head; // Oldest record offset
+    size_t used; // Used bytes
+    uint32_t records; // Stored records number
+    uint32_t dropped_records; // Records, dropped for the new ones
+
+    int64_t base_time_us; // Time before the oldest record
+    int32_t base_position; // Position before the oldest record
+    int64_t last_time_us; // Time of the newest record
+    int32_t last_position; // Position of the newest record
+    bool started; // Base values are set by the first sample
+
+} encoder_history;
+
+
+// Struct: encoder_history_iter
+// Purpose: Streaming iterator over the history records (from the oldest to the newest) or over the exported data
+typedef struct encoder_history_iter
+{
+
+    const uint8_t *buffer; // Records storage
+    size_t size; // Storage size (offsets are taken by modulo for the ring buffer)
+    size_t offset; // Current record offset
+    size_t end; // Records end offset
+    uint32_t remaining; // Records to decode
+
+    int64_t time_us; // Last decoded time
+    int32_t position; // Last decoded position
+
+} encoder_history_iter;
+
+// =========================================================================================== STRUCT DEFINITION SECTION
+
+
+// =========================================================================================== API DECLARATION
+
+// Function: encoder_history_init
+// Purpose: Initialize the history by the user storage
+void encoder_history_init(encoder_history *history, uint8_t *buffer, size_t size);
+
+
+// Function: encoder_history_clear
+// Purpose: Remove all the records from the history
+void encoder_history_clear(encoder_history *history);
+
+
+// Function: encoder_history_append
+// Purpose: Add the (time, position) sample as the delta record. Returns false for the storage, smaller than one record
+bool encoder_history_append(encoder_history *history, int64_t time_us, int32_t position);
+
+
+// Function: encoder_history_iter_begin
+// Purpose: Start the streaming iteration from the oldest record
+void encoder_history_iter_begin(const encoder_history *history, encoder_history_iter *iter);
+
+
+// Function: encoder_history_iter_next
+// Purpose: Decode the next sample. Returns false after the last record or for the broken data
+bool encoder_history_iter_next(encoder_history_iter *iter, encoder_history_sample *sample);
+
+
+// Function: encoder_history_export
+// Purpose: Copy the history into the linear buffer with the header for the device-to-host transfer.
+// Returns the exported size (0 for the small output buffer)
+size_t encoder_history_export(const encoder_history *history, uint8_t *out, size_t out_size);
+
+
+// Function: encoder_history_decode_begin
+// Purpose: Host-side decoder - start the iteration over the exported data. Returns false for the wrong header
+bool encoder_history_decode_begin(const uint8_t *data, size_t size, encoder_history_iter *iter);
+
+// =========================================================================================== API DECLARATION
+
+#endif // ENCODER_HISTORY_H
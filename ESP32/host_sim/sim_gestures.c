@@ -0,0 +1,206 @@
+// =========================================================================================== INFO
+
+// Encoder gesture engine host simulation (C version)
+// Author: dimakomplekt
+// Description: SW-button gesture sequences through the table control and the position control paths:
+// the reported events order and the active table entry against the expected ones.
+// Build: see sim_platform.h
+
+// =========================================================================================== INFO
+
+
+// =========================================================================================== IMPORT
+
+#include <stdio.h>
+#include <string.h>
+#include "encoder_control.h"
+#include "sim_platform.h"
+
+// =========================================================================================== IMPORT
+
+
+// =========================================================================================== DEFINES
+
+#define SIM_CLK GPIO_NUM_14
+#define SIM_DT  GPIO_NUM_12
+#define SIM_SW  GPIO_NUM_13
+
+#define SIM_POLL_PERIOD_US    500     // Control calls period
+#define SIM_CLICK_US          60000   // Short press time
+#define SIM_GAP_US            100000  // Release time between the presses of the double click
+#define SIM_LONG_HOLD_US      1000000 // Long press hold time
+#define SIM_QUARTER_STEP_US   2000    // Quarter step time of the press-and-turn
+#define SIM_SETTLE_US         1000000 // Time after the sequence (the double click window expiration)
+#define SIM_EVENTS_MAX        16      // Events log size
+
+// =========================================================================================== DEFINES
+
+
+// =========================================================================================== SIMULATION
+
+// Struct: sim_run_ctx
+// Purpose: Stores the one sequence run: encoder with the parameters table, knob position and the events log
+typedef struct sim_run_ctx
+{
+
+    encoder_ctx encoder; // Simulated encoder
+    encoder_parameter table[2]; // Parameters table (SW-button click switches the entries)
+    uint8_t values[2]; // Controlled variables
+    bool position_path; // enc_position_control instead of enc_table_rotation_control
+    int32_t quarter_steps; // Knob position
+    encoder_event_type events[SIM_EVENTS_MAX]; // Events log
+    uint8_t event_count; // Events number
+
+} sim_run_ctx;
+
+
+static const char *event_names[ENC_EVENT_COUNT] = {
+    "VALUE_CHANGED", "LIMIT_HIT", "WRAPPED", "SW_CLICK", "SW_DOUBLE_CLICK", "SW_LONG_PRESS", "PRESS_TURN", "HOMED", "INDEX_DRIFT",
+};
+
+
+// Run start: gesture engine, two table entries and the selected control path
+static void sim_run_start(sim_run_ctx *run, bool position_path)
+{
+    memset(run, 0, sizeof(*run));
+    sim_reset();
+    sim_quadrature_set(SIM_CLK, SIM_DT, 0);
+
+    run->position_path = position_path;
+    run->values[0] = 50;
+    run->values[1] = 50;
+
+    for (uint8_t i = 0; i < 2; i++)
+    {
+        run->table[i] = (encoder_parameter){ .link = &run->values[i], .type = TYPE_UINT_8, .side = CLOCKWISE,
+                                             .overflow_mode = LIMITATION, .step.u8 = 1, .min_val.u8 = 0, .max_val.u8 = 100 };
+    }
+
+    encoder_initialization(&run->encoder, GPIO_PIN_NONE, GPIO_PIN_NONE, SIM_SW, SIM_DT, SIM_CLK);
+    encoder_gesture_setup(&run->encoder, NULL);
+    encoder_parameter_table_bind(&run->encoder, run->table, 2, true);
+}
+
+
+// Control calls for the selected time with the events logging (one detent per 4 quarter steps for the turn)
+static void sim_run_for(sim_run_ctx *run, uint32_t time_us, int32_t turn_detents)
+{
+    int64_t end_us = sim_now_us + time_us;
+    int32_t target = run->quarter_steps + turn_detents * 4;
+    int64_t next_step_us = sim_now_us + SIM_QUARTER_STEP_US;
+
+    while (sim_now_us < end_us)
+    {
+        if (run->quarter_steps != target && sim_now_us >= next_step_us)
+        {
+            run->quarter_steps += (target > run->quarter_steps) ? 1 : -1;
+            next_step_us = sim_now_us + SIM_QUARTER_STEP_US;
+        }
+
+        sim_quadrature_set(SIM_CLK, SIM_DT, run->quarter_steps);
+
+        if (run->position_path) enc_position_control(&run->encoder);
+        else enc_table_rotation_control(&run->encoder);
+
+        encoder_event event;
+
+        while (encoder_event_pop(&run->encoder, &event))
+        {
+            if (event.type == ENC_EVENT_VALUE_CHANGED || event.type == ENC_EVENT_LIMIT_HIT) continue;
+            if (run->event_count < SIM_EVENTS_MAX) run->events[run->event_count++] = event.type;
+        }
+
+        sim_now_us += SIM_POLL_PERIOD_US;
+    }
+}
+
+
+// SW-button press for the selected time with the turn after the SW debounce, then the release
+static void sim_press(sim_run_ctx *run, uint32_t hold_us, int32_t turn_detents)
+{
+    uint32_t debounce_us = 2 * ENC_GESTURE_SW_DEBOUNCE_US_DEFAULT;
+
+    sim_pin_set(SIM_SW, false);
+    sim_run_for(run, debounce_us, 0);
+    sim_run_for(run, hold_us - debounce_us, turn_detents);
+    sim_pin_set(SIM_SW, true);
+}
+
+
+// Events log compare with the expected sequence, the active entry and the entries values check
+static bool sim_run_check(sim_run_ctx *run, const char *name, const encoder_event_type *expected, uint8_t expected_count,
+    uint8_t active_index, uint8_t value_0, uint8_t value_1) {
+
+    sim_run_for(run, SIM_SETTLE_US, 0);
+
+    bool passed = run->event_count == expected_count && memcmp(run->events, expected, expected_count * sizeof(expected[0])) == 0 &&
+                  run->encoder.active_index == active_index && run->values[0] == value_0 && run->values[1] == value_1;
+
+    printf("%-44s %-8s events:", name, run->position_path ? "position" : "table");
+    for (uint8_t i = 0; i < run->event_count; i++) printf(" %s", event_names[run->events[i]]);
+    printf(" | entry %u values %u/%u %s\n", (unsigned)run->encoder.active_index, (unsigned)run->values[0], (unsigned)run->values[1],
+           passed ? "ok" : "FAILED");
+
+    return passed;
+}
+
+// =========================================================================================== SIMULATION
+
+
+// =========================================================================================== MAIN
+
+int main(void)
+{
+    sim_run_ctx run;
+    bool passed = true;
+
+    for (int path = 0; path < 2; path++)
+    {
+        bool position_path = path == 1;
+
+        // Turn values: the table path steps the active entry by the coarse step, the position path keeps the values
+        uint8_t coarse = position_path ? 50 : 50 + 2 * ENC_GESTURE_COARSE_MULTIPLIER_DEFAULT;
+
+        // Single click - entry switch after the double click window
+        static const encoder_event_type single[] = { ENC_EVENT_SW_CLICK };
+        sim_run_start(&run, position_path);
+        sim_press(&run, SIM_CLICK_US, 0);
+        passed = sim_run_check(&run, "click", single, 1, 1, 50, 50) && passed;
+
+        // Double click - no single clicks
+        static const encoder_event_type double_click[] = { ENC_EVENT_SW_DOUBLE_CLICK };
+        sim_run_start(&run, position_path);
+        sim_press(&run, SIM_CLICK_US, 0);
+        sim_run_for(&run, SIM_GAP_US, 0);
+        sim_press(&run, SIM_CLICK_US, 0);
+        passed = sim_run_check(&run, "click + click", double_click, 1, 0, 50, 50) && passed;
+
+        // Click, then the long press inside the double click window - the click is reported before the long press
+        static const encoder_event_type click_long[] = { ENC_EVENT_SW_CLICK, ENC_EVENT_SW_LONG_PRESS };
+        sim_run_start(&run, position_path);
+        sim_press(&run, SIM_CLICK_US, 0);
+        sim_run_for(&run, SIM_GAP_US, 0);
+        sim_press(&run, SIM_LONG_HOLD_US, 0);
+        passed = sim_run_check(&run, "click + long press", click_long, 2, 1, 50, 50) && passed;
+
+        // Press-and-turn alone (one event per detent - the events are taken after each control call) - no click
+        static const encoder_event_type turn[] = { ENC_EVENT_PRESS_TURN, ENC_EVENT_PRESS_TURN };
+        sim_run_start(&run, position_path);
+        sim_press(&run, 40000, 2);
+        passed = sim_run_check(&run, "press-and-turn", turn, 2, 0, coarse, 50) && passed;
+
+        // Click, then the press-and-turn - the click is reported (entry switch), the turn goes to the new entry
+        static const encoder_event_type click_turn[] = { ENC_EVENT_SW_CLICK, ENC_EVENT_PRESS_TURN, ENC_EVENT_PRESS_TURN };
+        sim_run_start(&run, position_path);
+        sim_press(&run, SIM_CLICK_US, 0);
+        sim_run_for(&run, SIM_GAP_US, 0);
+        sim_press(&run, 40000, 2);
+        passed = sim_run_check(&run, "click + press-and-turn", click_turn, 3, 1, 50, coarse) && passed;
+    }
+
+    printf("%s\n", passed ? "PASSED" : "FAILED");
+
+    return passed ? 0 : 1;
+}
+
+// =========================================================================================== MAIN
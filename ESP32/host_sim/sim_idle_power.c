@@ -0,0 +1,212 @@
+// =========================================================================================== INFO
+
+// Encoder idle mode host simulation (C version)
+// Author: dimakomplekt
+// Description: Duty cycle, polls and wakeup latency (the first edge of the spin to its decoding) of the idle mode
+// (sleep until the encoder edge) against the continuous 2 kHz polling over the same knob trace, and the idle exit
+// to the first poll accounting for the foreign wakeups.
+// Build: see sim_platform.h
+
+// =========================================================================================== INFO
+
+
+// =========================================================================================== IMPORT
+
+#include <stdio.h>
+#include "encoder_control.h"
+#include "sim_platform.h"
+
+// =========================================================================================== IMPORT
+
+
+// =========================================================================================== DEFINES
+
+#define SIM_CLK GPIO_NUM_14
+#define SIM_DT  GPIO_NUM_12
+
+#define SIM_POLL_PERIOD_US    500       // Continuous polling period (2 kHz)
+#define SIM_IDLE_QUIET_US     50000     // Quiet period before the idle sleep
+#define SIM_SLEEP_STEP_US     10        // Wakeup check resolution inside the simulated sleep
+#define SIM_TRACE_US          60000000  // Trace length
+
+#define SIM_SPINS             6         // Knob spins in the trace
+#define SIM_SPIN_PERIOD_US    10000000  // Spin start period
+#define SIM_SPIN_DETENTS      20        // Detents per spin
+#define SIM_QUARTER_STEP_US   2000      // Quarter step time of the spin
+
+// =========================================================================================== DEFINES
+
+
+// =========================================================================================== TRACE
+
+// Spin start time by the index
+static int64_t trace_spin_start(int spin)
+{
+    return 2000000 + (int64_t)spin * SIM_SPIN_PERIOD_US;
+}
+
+
+// Trace quarter steps position by the time: the spins with the constant speed and the idle time between them
+static int32_t trace_quarter_steps(int64_t time_us)
+{
+    int32_t quarter_steps = 0;
+
+    for (int spin = 0; spin < SIM_SPINS; spin++)
+    {
+        int64_t since_start_us = time_us - trace_spin_start(spin);
+        if (since_start_us < 0) break;
+
+        int64_t spin_steps = since_start_us / SIM_QUARTER_STEP_US;
+        quarter_steps += (spin_steps > SIM_SPIN_DETENTS * 4) ? SIM_SPIN_DETENTS * 4 : (int32_t)spin_steps;
+    }
+
+    return quarter_steps;
+}
+
+// =========================================================================================== TRACE
+
+
+// =========================================================================================== SIMULATION
+
+// Struct: sim_result
+// Purpose: Stores the one run results
+typedef struct sim_result
+{
+
+    encoder_power_stats stats; // Power accounting of the run
+    int32_t position; // Decoded detents
+    int64_t max_wakeup_latency_us; // Maximal time from the first edge of the spin to its decoding (wakeup latency)
+
+} sim_result;
+
+
+// One trace run: continuous polling or the idle mode with the simulated light sleep
+static sim_result sim_run(bool idle_mode)
+{
+    sim_reset();
+    sim_quadrature_set(SIM_CLK, SIM_DT, 0);
+
+    encoder_ctx encoder;
+    encoder_initialization(&encoder, GPIO_PIN_NONE, GPIO_PIN_NONE, GPIO_PIN_NONE, SIM_DT, SIM_CLK);
+    encoder_decoder_setup(&encoder, ENC_DECODER_QUADRATURE);
+    if (idle_mode) encoder_idle_setup(&encoder, SIM_IDLE_QUIET_US);
+    encoder_power_stats_reset(&encoder);
+
+    sim_result result = {0};
+    int spin = 0;
+
+    while (sim_now_us < SIM_TRACE_US)
+    {
+        sim_quadrature_set(SIM_CLK, SIM_DT, trace_quarter_steps(sim_now_us));
+        enc_position_control(&encoder);
+
+        // Wakeup latency: from the first edge of the spin to its decoding
+        int64_t first_edge_us = trace_spin_start(spin) + SIM_QUARTER_STEP_US;
+
+        if (spin < SIM_SPINS && encoder.last_activity_us >= first_edge_us)
+        {
+            int64_t latency_us = encoder.last_activity_us - first_edge_us;
+            if (latency_us > result.max_wakeup_latency_us) result.max_wakeup_latency_us = latency_us;
+            spin++;
+        }
+
+        // Light sleep until the armed encoder pin level (the trace goes on inside the sleep)
+        if (encoder_idle_ready(&encoder))
+        {
+            encoder_idle_enter(&encoder);
+
+            do
+            {
+                sim_now_us += SIM_SLEEP_STEP_US;
+                sim_quadrature_set(SIM_CLK, SIM_DT, trace_quarter_steps(sim_now_us));
+            }
+            while (!sim_wakeup_triggered() && sim_now_us < SIM_TRACE_US);
+
+            sim_now_us += SIM_LIGHT_SLEEP_EXIT_US;
+            encoder_idle_exit(&encoder);
+            continue;
+        }
+
+        sim_now_us += SIM_POLL_PERIOD_US;
+    }
+
+    encoder_power_stats_get(&encoder, &result.stats);
+    result.position = encoder.position;
+
+    return result;
+}
+
+
+// Wakeup by the other source (timer) and the knob touch a minute later: the exit to poll delay must not be counted
+static bool sim_foreign_wakeup(void)
+{
+    sim_reset();
+    sim_quadrature_set(SIM_CLK, SIM_DT, 0);
+
+    encoder_ctx encoder;
+    encoder_initialization(&encoder, GPIO_PIN_NONE, GPIO_PIN_NONE, GPIO_PIN_NONE, SIM_DT, SIM_CLK);
+    encoder_idle_setup(&encoder, SIM_IDLE_QUIET_US);
+
+    sim_now_us += SIM_IDLE_QUIET_US;
+    enc_position_control(&encoder);
+
+    // Timer wakeup after 1 s without the encoder input
+    encoder_idle_enter(&encoder);
+    sim_now_us += 1000000;
+    encoder_idle_exit(&encoder);
+
+    // Polling without the input for a minute, then the knob touch
+    for (int i = 0; i < 120; i++)
+    {
+        sim_now_us += SIM_POLL_PERIOD_US * 1000;
+        enc_position_control(&encoder);
+    }
+
+    sim_quadrature_set(SIM_CLK, SIM_DT, 1);
+    enc_position_control(&encoder);
+
+    encoder_power_stats stats;
+    encoder_power_stats_get(&encoder, &stats);
+
+    printf("foreign wakeup: wakeups=%u exit to poll last=%u us max=%u us\n",
+           (unsigned)stats.wakeups, (unsigned)stats.last_exit_poll_delay_us, (unsigned)stats.max_exit_poll_delay_us);
+
+    return stats.max_exit_poll_delay_us == 0;
+}
+
+// =========================================================================================== SIMULATION
+
+
+// =========================================================================================== MAIN
+
+int main(void)
+{
+    sim_result continuous = sim_run(false);
+    sim_result idle = sim_run(true);
+    int32_t expected = SIM_SPINS * SIM_SPIN_DETENTS;
+
+    printf("trace: %d spins x %d detents, %d us per quarter step, %d s\n",
+           SIM_SPINS, SIM_SPIN_DETENTS, SIM_QUARTER_STEP_US, SIM_TRACE_US / 1000000);
+
+    printf("continuous: polls=%u duty=%u%% detents=%d/%d wakeup latency max=%lld us\n",
+           (unsigned)continuous.stats.polls, encoder_power_duty_cycle_permille(&continuous.stats) / 10,
+           (int)continuous.position, (int)expected, (long long)continuous.max_wakeup_latency_us);
+
+    printf("idle mode:  polls=%u (continuous %u) duty=%u.%u%% wakeups=%u detents=%d/%d wakeup latency max=%lld us "
+           "(exit to poll max=%u us)\n",
+           (unsigned)idle.stats.polls, (unsigned)encoder_power_continuous_polls(&idle.stats, SIM_POLL_PERIOD_US),
+           encoder_power_duty_cycle_permille(&idle.stats) / 10, encoder_power_duty_cycle_permille(&idle.stats) % 10,
+           (unsigned)idle.stats.wakeups, (int)idle.position, (int)expected, (long long)idle.max_wakeup_latency_us,
+           (unsigned)idle.stats.max_exit_poll_delay_us);
+
+    // Idle mode wakeup latency: the light sleep exit and one poll period at most
+    bool passed = continuous.position == expected && idle.position == expected &&
+                  idle.max_wakeup_latency_us <= SIM_LIGHT_SLEEP_EXIT_US + SIM_POLL_PERIOD_US;
+    passed = sim_foreign_wakeup() && passed;
+
+    printf("%s\n", passed ? "PASSED" : "FAILED");
+
+    return passed ? 0 : 1;
+}
+
+// =========================================================================================== MAIN
@@ -0,0 +1,183 @@
+// =========================================================================================== INFO
+
+// Encoder index channel host simulation (C version)
+// Author: dimakomplekt
+// Description: Counts per revolution check of the index (Z) channel with the reversals, the wiggles across the index
+// and the injected missed counts: drift events and the final position against the knob position for each decoder.
+// Build: see sim_platform.h
+
+// =========================================================================================== INFO
+
+
+// =========================================================================================== IMPORT
+
+#include <stdio.h>
+#include "encoder_control.h"
+#include "sim_platform.h"
+
+// =========================================================================================== IMPORT
+
+
+// =========================================================================================== DEFINES
+
+#define SIM_CLK GPIO_NUM_14
+#define SIM_DT  GPIO_NUM_12
+#define SIM_Z   GPIO_NUM_27
+
+#define SIM_POLL_PERIOD_US    250     // Control calls period
+#define SIM_QUARTER_STEP_US   2000    // Quarter step time of the knob moves
+#define SIM_COUNTS_PER_REV    20      // Detents per revolution
+#define SIM_QUARTERS_PER_REV  (SIM_COUNTS_PER_REV * 4)
+#define SIM_Z_QUARTER         22      // Quarter state with the high Z level inside the revolution
+
+// =========================================================================================== DEFINES
+
+
+// =========================================================================================== SIMULATION
+
+// Struct: sim_run_ctx
+// Purpose: Stores the one scenario run: encoder with the index channel and the knob position
+typedef struct sim_run_ctx
+{
+
+    encoder_ctx encoder; // Simulated encoder
+    int32_t quarter_steps; // Knob position (quarter steps)
+
+} sim_run_ctx;
+
+
+// Struct: sim_scenario
+// Purpose: Stores one scenario: knob moves (quarter steps targets) with the injected jumps and the expected position error
+typedef struct sim_scenario
+{
+
+    const char *name; // Scenario name
+    int32_t moves[16]; // Targets of the moves (the jumps are marked by SIM_JUMP)
+    uint8_t move_count; // Moves number
+    int32_t missed_error; // Position error of the missed counts without the correction (one drift event per count)
+
+} sim_scenario;
+
+// Jump mark inside the moves: one detent (4 quarter steps) between two polls in the direction of the next move
+#define SIM_JUMP INT32_MIN
+
+
+static const char *decoder_names[] = { "clk edge", "quadrature", "recovery" };
+
+
+// Pins by the knob position: quadrature and the Z level on one quarter state per revolution
+static void sim_pins_set(int32_t quarter_steps)
+{
+    int32_t phase = quarter_steps % SIM_QUARTERS_PER_REV;
+    if (phase < 0) phase += SIM_QUARTERS_PER_REV;
+
+    sim_quadrature_set(SIM_CLK, SIM_DT, quarter_steps);
+    sim_pin_set(SIM_Z, phase == SIM_Z_QUARTER);
+}
+
+
+// Control calls for the selected time
+static void sim_poll_for(sim_run_ctx *run, int64_t time_us)
+{
+    int64_t end_us = sim_now_us + time_us;
+
+    while (sim_now_us < end_us)
+    {
+        sim_pins_set(run->quarter_steps);
+        enc_position_control(&run->encoder);
+        sim_now_us += SIM_POLL_PERIOD_US;
+    }
+}
+
+
+// Knob move to the target quarter steps position by one quarter step per SIM_QUARTER_STEP_US
+static void sim_move_to(sim_run_ctx *run, int32_t target)
+{
+    while (run->quarter_steps != target)
+    {
+        run->quarter_steps += (target > run->quarter_steps) ? 1 : -1;
+        sim_poll_for(run, SIM_QUARTER_STEP_US);
+    }
+
+    sim_poll_for(run, 20000);
+}
+
+
+// One scenario run with the selected decoder and the drift correction mode. Returns true for the expected result
+static bool sim_scenario_run(const sim_scenario *scenario, encoder_decoder_mode mode, bool correction)
+{
+    sim_run_ctx run = {0};
+
+    sim_reset();
+    sim_pins_set(0);
+
+    encoder_initialization(&run.encoder, GPIO_PIN_NONE, GPIO_PIN_NONE, GPIO_PIN_NONE, SIM_DT, SIM_CLK);
+    encoder_decoder_setup(&run.encoder, mode);
+    encoder_index_setup(&run.encoder, SIM_Z, SIM_COUNTS_PER_REV, correction);
+    sim_poll_for(&run, 10000);
+
+    for (uint8_t i = 0; i < scenario->move_count; i++)
+    {
+        if (scenario->moves[i] == SIM_JUMP)
+        {
+            // Missed count: the whole quadrature period between two polls
+            run.quarter_steps += (scenario->moves[i + 1] > run.quarter_steps) ? 4 : -4;
+            continue;
+        }
+
+        sim_move_to(&run, scenario->moves[i]);
+    }
+
+    // Knob position in detents (the moves are the whole detents from the zero)
+    int32_t expected_position = run.quarter_steps / 4;
+    int32_t position_error = run.encoder.position - expected_position;
+
+    // Correction returns the position to the knob position, without the correction the missed counts stay
+    uint32_t expected_drift_events = (uint32_t)((scenario->missed_error < 0) ? -scenario->missed_error : scenario->missed_error);
+
+    bool passed = run.encoder.drift_events == expected_drift_events &&
+                  position_error == (correction ? 0 : scenario->missed_error);
+
+    printf("    %-10s correction %-3s: index pulses %3u, drift events %u, position %4d (knob %4d) %s\n",
+           decoder_names[mode], correction ? "on" : "off", (unsigned)run.encoder.index_pulses, (unsigned)run.encoder.drift_events,
+           (int)run.encoder.position, (int)expected_position, passed ? "ok" : "FAILED");
+
+    return passed;
+}
+
+// =========================================================================================== SIMULATION
+
+
+// =========================================================================================== MAIN
+
+int main(void)
+{
+    static const sim_scenario scenarios[] = {
+        { "3 revolutions forward, 3 back", { 3 * SIM_QUARTERS_PER_REV, 0 }, 2, 0 },
+        { "5 detent wiggles across the index", { 20, 28, 16, 28, 16, 28, 16, 28, 16, 28, 16, 0 }, 12, 0 },
+        { "reversals between the index pulses", { 100, 60, 180, 140, 260, 20, 0 }, 7, 0 },
+        { "missed count forward, then back", { 100, SIM_JUMP, 260, 0 }, 4, -1 },
+        { "missed count back", { 260, 180, SIM_JUMP, 0 }, 4, 1 },
+    };
+
+    bool passed = true;
+
+    printf("index: %d counts per revolution, Z high on quarter state %d\n", SIM_COUNTS_PER_REV, SIM_Z_QUARTER);
+
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++)
+    {
+        printf("%s:\n", scenarios[i].name);
+
+        for (int mode = ENC_DECODER_CLK_EDGE; mode <= ENC_DECODER_QUADRATURE_RECOVERY; mode++)
+        {
+            passed = sim_scenario_run(&scenarios[i], (encoder_decoder_mode)mode, true) && passed;
+            passed = sim_scenario_run(&scenarios[i], (encoder_decoder_mode)mode, false) && passed;
+        }
+    }
+
+    printf("%s\n", passed ? "PASSED" : "FAILED");
+
+    return passed ? 0 : 1;
+}
+
+// =========================================================================================== MAIN
@@ -0,0 +1,218 @@
+// =========================================================================================== INFO
+
+// Encoder control host simulation platform (main File, C version)
+// Author: dimakomplekt
+// Description: Stub ESP-IDF functions by the simulated time and the simulated GPIO levels
+
+// =========================================================================================== INFO
+
+
+// =========================================================================================== IMPORT
+
+#include <string.h>
+#include "soc/gpio_struct.h"
+#include "esp_timer.h"
+#include "esp_sleep.h"
+#include <my_libs/async_await/async_await.h>
+#include <my_libs/button_control/button_contol.h>
+
+// Header import
+#include "sim_platform.h"
+
+// =========================================================================================== IMPORT
+
+
+// =========================================================================================== DEFINES
+
+#define SIM_PINS_NUMBER 64
+
+// =========================================================================================== DEFINES
+
+
+// =========================================================================================== SIMULATION STATE
+
+gpio_dev_t GPIO;
+int64_t sim_now_us;
+
+static gpio_int_type_t wakeup_type[SIM_PINS_NUMBER]; // Armed wakeup level by the pin
+static bool gpio_wakeup_source; // GPIO wakeup source is enabled
+
+// =========================================================================================== SIMULATION STATE
+
+
+// =========================================================================================== STUB ESP-IDF
+
+int64_t esp_timer_get_time(void)
+{
+    return sim_now_us;
+}
+
+
+esp_err_t gpio_set_direction(gpio_num_t gpio_num, gpio_mode_t mode)
+{
+    (void)gpio_num;
+    (void)mode;
+    return 0;
+}
+
+
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level)
+{
+    sim_pin_set(gpio_num, level != 0);
+    return 0;
+}
+
+
+esp_err_t gpio_set_pull_mode(gpio_num_t gpio_num, gpio_pull_mode_t pull)
+{
+    (void)gpio_num;
+    (void)pull;
+    return 0;
+}
+
+
+esp_err_t gpio_wakeup_enable(gpio_num_t gpio_num, gpio_int_type_t intr_type)
+{
+    if (gpio_num < 0 || gpio_num >= SIM_PINS_NUMBER) return -1;
+
+    wakeup_type[gpio_num] = intr_type;
+    return 0;
+}
+
+
+esp_err_t gpio_wakeup_disable(gpio_num_t gpio_num)
+{
+    if (gpio_num < 0 || gpio_num >= SIM_PINS_NUMBER) return -1;
+
+    wakeup_type[gpio_num] = GPIO_INTR_DISABLE;
+    return 0;
+}
+
+
+esp_err_t esp_sleep_enable_gpio_wakeup(void)
+{
+    gpio_wakeup_source = true;
+    return 0;
+}
+
+
+async_await_ctx async_await_ctx_default(void)
+{
+    return (async_await_ctx){ .start_us = 0, .started = false };
+}
+
+
+// True after the selected time from the waiting start, the next waiting starts from the next call
+bool async_await(async_await_ctx *ctx, long value, time_unit unit, bool restart)
+{
+    (void)restart;
+
+    int64_t wait_us = (unit == TIME_UNIT_S) ? value * 1000000LL : (unit == TIME_UNIT_MS) ? value * 1000LL : value;
+
+    if (!ctx->started || sim_now_us - ctx->start_us >= wait_us)
+    {
+        ctx->start_us = sim_now_us;
+        ctx->started = true;
+        return true;
+    }
+
+    return false;
+}
+
+
+void await(long value, time_unit unit)
+{
+    sim_now_us += (unit == TIME_UNIT_S) ? value * 1000000LL : (unit == TIME_UNIT_MS) ? value * 1000LL : value;
+}
+
+
+button_ctx button_initialization(gpio_num_t pin, gpio_pull_mode_t pull, fix_mode mode)
+{
+    (void)pull;
+    (void)mode;
+    return (button_ctx){ .pin = pin, .last_pressed = false };
+}
+
+
+// One-time flag by the press (low level) front
+void flag_control_by_but_onetime_press(button_ctx *button, bool *flag)
+{
+    bool pressed = !sim_pin_get(button->pin);
+
+    if (pressed && !button->last_pressed) *flag = true;
+
+    button->last_pressed = pressed;
+}
+
+// =========================================================================================== STUB ESP-IDF
+
+
+// =========================================================================================== API DEFINITION SECTION
+
+void sim_reset(void)
+{
+    sim_now_us = 1;
+    GPIO.in = UINT32_MAX;
+    GPIO.in1.val = UINT32_MAX;
+
+    memset(wakeup_type, 0, sizeof(wakeup_type));
+    gpio_wakeup_source = false;
+}
+
+
+void sim_pin_set(gpio_num_t pin, bool level)
+{
+    if (pin < 0 || pin >= SIM_PINS_NUMBER) return;
+
+    volatile uint32_t *reg = (pin < 32) ? &GPIO.in : &GPIO.in1.val;
+    uint32_t mask = 1u << (pin & 31);
+
+    if (level) *reg |= mask;
+    else *reg &= ~mask;
+}
+
+
+bool sim_pin_get(gpio_num_t pin)
+{
+    if (pin < 0 || pin >= SIM_PINS_NUMBER) return true;
+
+    return (pin < 32) ? (GPIO.in >> pin) & 0x1 : (GPIO.in1.val >> (pin - 32)) & 0x1;
+}
+
+
+void sim_quadrature_set(gpio_num_t clk_pin, gpio_num_t dt_pin, int32_t quarter_steps)
+{
+    static const bool clk_levels[4] = { false, true, true, false };
+    static const bool dt_levels[4] = { false, false, true, true };
+
+    int phase = quarter_steps & 0x3;
+
+    sim_pin_set(clk_pin, clk_levels[phase]);
+    sim_pin_set(dt_pin, dt_levels[phase]);
+}
+
+
+bool sim_wakeup_triggered(void)
+{
+    if (!gpio_wakeup_source) return false;
+
+    for (int pin = 0; pin < SIM_PINS_NUMBER; pin++)
+    {
+        if (wakeup_type[pin] == GPIO_INTR_LOW_LEVEL && !sim_pin_get(pin)) return true;
+        if (wakeup_type[pin] == GPIO_INTR_HIGH_LEVEL && sim_pin_get(pin)) return true;
+    }
+
+    return false;
+}
+
+
+int sim_wakeups_armed(void)
+{
+    int armed = 0;
+
+    for (int pin = 0; pin < SIM_PINS_NUMBER; pin++) if (wakeup_type[pin] != GPIO_INTR_DISABLE) armed++;
+
+    return armed;
+}
+
+// =========================================================================================== API DEFINITION SECTION
@@ -0,0 +1,69 @@
+// =========================================================================================== INFO
+
+// Encoder control host simulation platform (Header File, C version)
+// Author: dimakomplekt
+// Description: Simulated time, GPIO levels and light sleep wakeups for the encoder_control host harnesses.
+// The real encoder_control.c / encoder_history.c are built against the stub ESP-IDF headers (host_sim/stubs):
+//
+// gcc -std=c11 -Wall -Wextra -IESP32/host_sim/stubs -IESP32 ESP32/host_sim/<harness>.c ESP32/host_sim/sim_platform.c
+//     ESP32/encoder_control.c ESP32/encoder_history.c -lm -o <harness>
+//
+// Each harness prints its report and returns non-zero for the failed checks
+
+// =========================================================================================== INFO
+
+
+// =========================================================================================== DEFINES
+
+#ifndef SIM_PLATFORM_H
+#define SIM_PLATFORM_H
+
+// Modeled light sleep exit time (GPIO wakeup to the first instruction)
+#define SIM_LIGHT_SLEEP_EXIT_US 500
+
+// =========================================================================================== DEFINES
+
+
+// =========================================================================================== IMPORT
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "driver/gpio.h"
+
+// =========================================================================================== IMPORT
+
+
+// =========================================================================================== API DECLARATION
+
+// Simulated time (esp_timer_get_time)
+extern int64_t sim_now_us;
+
+
+// Function: sim_reset
+// Purpose: Reset the simulated time, all the pins to the high level (pull-ups) and the wakeups
+void sim_reset(void);
+
+
+// Function: sim_pin_set / sim_pin_get
+// Purpose: Simulated input pin level
+void sim_pin_set(gpio_num_t pin, bool level);
+bool sim_pin_get(gpio_num_t pin);
+
+
+// Function: sim_quadrature_set
+// Purpose: Set (CLK, DT) by the quarter steps position: positive order 00 -> 10 -> 11 -> 01 (one detent per 4 quarter steps)
+void sim_quadrature_set(gpio_num_t clk_pin, gpio_num_t dt_pin, int32_t quarter_steps);
+
+
+// Function: sim_wakeup_triggered
+// Purpose: Checks if any armed GPIO wakeup pin has its wakeup level (with esp_sleep_enable_gpio_wakeup call)
+bool sim_wakeup_triggered(void);
+
+
+// Function: sim_wakeups_armed
+// Purpose: Number of the armed GPIO wakeup pins
+int sim_wakeups_armed(void);
+
+// =========================================================================================== API DECLARATION
+
+#endif // SIM_PLATFORM_H
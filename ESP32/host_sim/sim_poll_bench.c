@@ -0,0 +1,392 @@
+// =========================================================================================== INFO
+
+// Encoder adaptive polling host benchmark (C version)
+// Author: dimakomplekt
+// Description: Poll count against the missed detents over the knob traces: the fixed 2 kHz polling and the adaptive
+// polling (encoder_next_poll_us) with the different maximal intervals, the recovery decoder for all the runs
+// (the poll interval by the decoder velocity).
+// Traces: the built-in synthetic sessions, or the recorded trace from the CSV file (first argument) with
+// "time_us,quarter_steps" lines (the quarter steps position in the 00 -> 10 -> 11 -> 01 order, sorted by the time).
+// Build: see sim_platform.h
+
+// =========================================================================================== INFO
+
+
+// =========================================================================================== IMPORT
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "encoder_control.h"
+#include "sim_platform.h"
+
+// =========================================================================================== IMPORT
+
+
+// =========================================================================================== DEFINES
+
+#define SIM_CLK GPIO_NUM_14
+#define SIM_DT  GPIO_NUM_12
+
+#define SIM_FIXED_POLL_US    500      // Fixed polling period (2 kHz)
+#define SIM_TRACE_MAX_STEPS  200000   // Trace changes limit
+#define SIM_TRACE_MAX_CHECKS 1024     // Trace checkpoints limit
+#define SIM_SLOW_STEP_US     6000     // Quarter step time at the start of the accelerated spin
+#define SIM_RAMP_STEPS       16       // Acceleration and deceleration length of the accelerated spin (quarter steps)
+#define SIM_INSTANT_SPINS    20       // Spins of the instant spin-up traces
+
+// =========================================================================================== DEFINES
+
+
+// =========================================================================================== TRACE
+
+// Struct: sim_trace
+// Purpose: Stores the knob trace: the quarter steps position changes and the checkpoints (the knob is at rest)
+typedef struct sim_trace
+{
+
+    const char *name; // Trace name
+    int64_t times_us[SIM_TRACE_MAX_STEPS]; // Change times
+    int32_t positions[SIM_TRACE_MAX_STEPS]; // Quarter steps positions after the changes
+    size_t count; // Changes number
+    int64_t checks_us[SIM_TRACE_MAX_CHECKS]; // Checkpoints times
+    size_t check_count; // Checkpoints number
+    int64_t end_us; // Trace end
+
+} sim_trace;
+
+
+// Struct: sim_spin
+// Purpose: Stores one spin of the synthetic trace
+typedef struct sim_spin
+{
+
+    uint32_t idle_us; // Rest time before the spin
+    int32_t detents; // Detents (the sign - direction)
+    uint32_t quarter_step_us; // Quarter step time at the full speed
+    bool accelerated; // Acceleration from SIM_SLOW_STEP_US for SIM_RAMP_STEPS and the same deceleration (else - instant start)
+
+} sim_spin;
+
+
+static sim_trace trace;
+
+
+// Deterministic random source (LCG)
+static uint32_t sim_random(uint32_t *seed)
+{
+    *seed = *seed * 1664525u + 1013904223u;
+    return *seed >> 8;
+}
+
+
+// Spins into the trace changes with the checkpoint before each spin and at the end
+static void sim_trace_build(const char *name, const sim_spin *spins, size_t spin_count)
+{
+    int64_t time_us = 1000;
+    int32_t position = 0;
+
+    trace.name = name;
+    trace.count = 0;
+    trace.check_count = 0;
+
+    for (size_t i = 0; i < spin_count && trace.count < SIM_TRACE_MAX_STEPS; i++)
+    {
+        time_us += spins[i].idle_us;
+        if (trace.check_count < SIM_TRACE_MAX_CHECKS) trace.checks_us[trace.check_count++] = time_us;
+
+        int32_t steps = abs(spins[i].detents) * 4;
+        int32_t direction = (spins[i].detents > 0) ? 1 : -1;
+
+        for (int32_t step = 0; step < steps && trace.count < SIM_TRACE_MAX_STEPS; step++)
+        {
+            int64_t interval_us = spins[i].quarter_step_us;
+
+            // Linear speed ramp at the start and the stop
+            if (spins[i].accelerated)
+            {
+                int32_t edge_distance = (step < steps - 1 - step) ? step : steps - 1 - step;
+
+                if (edge_distance < SIM_RAMP_STEPS)
+                    interval_us = SIM_SLOW_STEP_US - (int64_t)edge_distance * (SIM_SLOW_STEP_US - (int64_t)spins[i].quarter_step_us) / SIM_RAMP_STEPS;
+            }
+
+            time_us += interval_us;
+            position += direction;
+
+            trace.times_us[trace.count] = time_us;
+            trace.positions[trace.count] = position;
+            trace.count++;
+        }
+    }
+
+    trace.end_us = time_us + 1000000;
+    if (trace.check_count < SIM_TRACE_MAX_CHECKS) trace.checks_us[trace.check_count++] = trace.end_us;
+}
+
+
+// UI session: short and long spins with the acceleration and the rest between them
+static void sim_trace_ui_session(void)
+{
+    static sim_spin spins[120];
+    uint32_t seed = 2024;
+
+    for (size_t i = 0; i < 120; i++)
+    {
+        spins[i].idle_us = 300000 + sim_random(&seed) % 3000000;
+        spins[i].detents = (int32_t)(1 + sim_random(&seed) % 40) * ((sim_random(&seed) & 1) ? 1 : -1);
+        spins[i].quarter_step_us = 400 + sim_random(&seed) % 2600;
+        spins[i].accelerated = true;
+    }
+
+    sim_trace_build("ui session (accelerated spins)", spins, 120);
+}
+
+
+// Fine adjustment: single detents at the slow speed
+static void sim_trace_fine_adjust(void)
+{
+    static sim_spin spins[200];
+
+    for (size_t i = 0; i < 200; i++)
+    {
+        spins[i] = (sim_spin){ .idle_us = 300000, .detents = (i % 20 < 10) ? 1 : -1, .quarter_step_us = 3000, .accelerated = false };
+    }
+
+    sim_trace_build("fine adjust (single detents)", spins, 200);
+}
+
+
+// Instant spin-ups after the rest: full speed from the first edge
+static void sim_trace_instant_spin(uint32_t quarter_step_us, const char *name)
+{
+    static sim_spin spins[SIM_INSTANT_SPINS];
+
+    for (size_t i = 0; i < SIM_INSTANT_SPINS; i++)
+    {
+        spins[i] = (sim_spin){ .idle_us = 2000000, .detents = 100, .quarter_step_us = quarter_step_us, .accelerated = false };
+    }
+
+    sim_trace_build(name, spins, SIM_INSTANT_SPINS);
+}
+
+
+// Recorded trace from the CSV file ("time_us,quarter_steps"), one checkpoint at the end
+static bool sim_trace_load(const char *path)
+{
+    FILE *file = fopen(path, "r");
+    if (!file) return false;
+
+    long long time_us;
+    long position;
+
+    trace.name = path;
+    trace.count = 0;
+    trace.check_count = 0;
+
+    while (trace.count < SIM_TRACE_MAX_STEPS && fscanf(file, "%lld,%ld", &time_us, &position) == 2)
+    {
+        trace.times_us[trace.count] = time_us;
+        trace.positions[trace.count] = (int32_t)position;
+        trace.count++;
+    }
+
+    fclose(file);
+
+    if (trace.count == 0) return false;
+
+    trace.end_us = trace.times_us[trace.count - 1] + 1000000;
+    trace.checks_us[trace.check_count++] = trace.end_us;
+
+    return true;
+}
+
+// =========================================================================================== TRACE
+
+
+// =========================================================================================== SIMULATION
+
+// Struct: sim_result
+// Purpose: Stores the one run results
+typedef struct sim_result
+{
+
+    uint32_t polls; // Control calls
+    uint32_t missed; // Detents error at the checkpoints
+    uint32_t recovered; // Recovered skipped states
+    uint32_t ambiguous; // Dropped skipped states
+
+} sim_result;
+
+
+// One trace run: max_interval_us == 0 - fixed polling, else the adaptive polling with the selected maximal interval
+static sim_result sim_run(uint32_t max_interval_us)
+{
+    sim_reset();
+    sim_quadrature_set(SIM_CLK, SIM_DT, 0);
+
+    encoder_ctx encoder;
+    encoder_initialization(&encoder, GPIO_PIN_NONE, GPIO_PIN_NONE, GPIO_PIN_NONE, SIM_DT, SIM_CLK);
+    encoder_decoder_setup(&encoder, ENC_DECODER_QUADRATURE_RECOVERY);
+
+    if (max_interval_us != 0)
+    {
+        encoder_poll_config config = encoder_poll_config_default();
+        config.max_interval_us = max_interval_us;
+        encoder_poll_setup(&encoder, &config);
+    }
+
+    sim_result result = {0};
+    size_t change = 0;
+    size_t check = 0;
+    int32_t position = 0;
+
+    while (sim_now_us < trace.end_us)
+    {
+        while (change < trace.count && trace.times_us[change] <= sim_now_us) position = trace.positions[change++];
+
+        // Checkpoint: detents error, then the resync (position and the detent boundary) for the next part of the trace
+        while (check < trace.check_count && trace.checks_us[check] <= sim_now_us)
+        {
+            int32_t expected = (position >= 0) ? position / 4 : -((-position) / 4);
+            result.missed += (uint32_t)abs(encoder.position - expected);
+            encoder.position = expected;
+            encoder.quad_steps = (int8_t)(position - expected * 4);
+            check++;
+        }
+
+        sim_quadrature_set(SIM_CLK, SIM_DT, position);
+        enc_position_control(&encoder);
+        result.polls++;
+
+        int64_t next_us = (max_interval_us != 0) ? encoder_next_poll_us(&encoder) : sim_now_us + SIM_FIXED_POLL_US;
+        sim_now_us = (next_us > sim_now_us) ? next_us : sim_now_us + 1;
+    }
+
+    result.recovered = encoder.recovered_steps;
+    result.ambiguous = encoder.ambiguous_steps;
+
+    return result;
+}
+
+
+// Constant spin: polls per quadrature phase in the steady state (ENC_POLL_PHASE_SAMPLES_DEFAULT expected)
+static bool sim_constant_spin_report(uint32_t quarter_step_us)
+{
+    sim_reset();
+    sim_quadrature_set(SIM_CLK, SIM_DT, 0);
+
+    encoder_ctx encoder;
+    encoder_initialization(&encoder, GPIO_PIN_NONE, GPIO_PIN_NONE, GPIO_PIN_NONE, SIM_DT, SIM_CLK);
+    encoder_decoder_setup(&encoder, ENC_DECODER_QUADRATURE_RECOVERY);
+    encoder_poll_setup(&encoder, NULL);
+
+    // Start out of the poll grid, steady state after the first second
+    int64_t start_us = 1337;
+    uint32_t steady_polls = 0;
+
+    while (sim_now_us < start_us + 2000000)
+    {
+        sim_quadrature_set(SIM_CLK, SIM_DT, (sim_now_us < start_us) ? 0 : (int32_t)((sim_now_us - start_us) / quarter_step_us));
+        enc_position_control(&encoder);
+
+        if (sim_now_us >= start_us + 1000000) steady_polls++;
+
+        int64_t next_us = encoder_next_poll_us(&encoder);
+        sim_now_us = (next_us > sim_now_us) ? next_us : sim_now_us + 1;
+    }
+
+    double polls_per_phase = (double)steady_polls * quarter_step_us / 1000000.0;
+
+    printf("    quarter step %4u us: polls per phase %.2f\n", (unsigned)quarter_step_us, polls_per_phase);
+
+    return polls_per_phase >= ENC_POLL_PHASE_SAMPLES_DEFAULT * 0.9 && polls_per_phase <= ENC_POLL_PHASE_SAMPLES_DEFAULT * 1.3;
+}
+
+
+// All the strategies over the current trace. Returns true if the default maximal interval misses not more than
+// the fixed polling plus the allowed detents
+static bool sim_trace_report(uint32_t allowed_missed)
+{
+    static const uint32_t max_intervals_us[] = { 0, 1000, 2000, 5000, 10000, 20000 };
+
+    sim_result fixed = sim_run(0);
+    bool default_passed = true;
+
+    printf("%s: %zu quarter steps, %.1f s\n", trace.name, trace.count, (double)trace.end_us / 1000000.0);
+
+    for (size_t i = 0; i < sizeof(max_intervals_us) / sizeof(max_intervals_us[0]); i++)
+    {
+        uint32_t max_interval_us = max_intervals_us[i];
+
+        sim_result result = (max_interval_us == 0) ? fixed : sim_run(max_interval_us);
+
+        if (max_interval_us == 0) printf("    fixed 2 kHz      ");
+        else printf("    adaptive max %5u%s", (unsigned)max_interval_us, (max_interval_us == ENC_POLL_MAX_INTERVAL_US_DEFAULT) ? "*" : " ");
+
+        printf(" polls %8u (%5.1f%%), missed detents %4u, recovered %5u, ambiguous %4u\n", (unsigned)result.polls,
+               100.0 * result.polls / fixed.polls, (unsigned)result.missed, (unsigned)result.recovered, (unsigned)result.ambiguous);
+
+        if (max_interval_us == ENC_POLL_MAX_INTERVAL_US_DEFAULT && result.missed > fixed.missed + allowed_missed) default_passed = false;
+    }
+
+    return default_passed;
+}
+
+// =========================================================================================== SIMULATION
+
+
+// =========================================================================================== MAIN
+
+int main(int argc, char **argv)
+{
+    printf("* - default maximal interval (ENC_POLL_MAX_INTERVAL_US_DEFAULT)\n");
+
+    // Recorded trace
+    if (argc > 1)
+    {
+        if (!sim_trace_load(argv[1]))
+        {
+            printf("trace load error: %s\n", argv[1]);
+            return 1;
+        }
+
+        sim_trace_report(0);
+        return 0;
+    }
+
+    // Sampling correction: the steady poll interval by the phase time
+    bool passed = true;
+
+    printf("constant spin, default configuration:\n");
+    passed = sim_constant_spin_report(2000) && passed;
+    passed = sim_constant_spin_report(1000) && passed;
+    passed = sim_constant_spin_report(700) && passed;
+    passed = sim_constant_spin_report(500) && passed;
+
+    // Built-in traces: the default must not miss more than the fixed polling on the accelerated and slow traces
+    // and on the instant spin-ups with the quarter step not shorter than the default maximal interval
+
+    sim_trace_ui_session();
+    passed = sim_trace_report(0) && passed;
+
+    sim_trace_fine_adjust();
+    passed = sim_trace_report(0) && passed;
+
+    sim_trace_instant_spin(2000, "instant spin-up, 2000 us quarter step");
+    passed = sim_trace_report(0) && passed;
+
+    // Faster instant spin-ups: the first edges of the spin are seen after the maximal interval - one detent
+    // per spin start at most (the whole quadrature period inside the first poll gap)
+
+    sim_trace_instant_spin(1000, "instant spin-up, 1000 us quarter step");
+    passed = sim_trace_report(SIM_INSTANT_SPINS) && passed;
+
+    sim_trace_instant_spin(500, "instant spin-up, 500 us quarter step");
+    passed = sim_trace_report(SIM_INSTANT_SPINS) && passed;
+
+    printf("%s\n", passed ? "PASSED" : "FAILED");
+
+    return passed ? 0 : 1;
+}
+
+// =========================================================================================== MAIN
@@ -0,0 +1,299 @@
+// =========================================================================================== INFO
+
+// Encoder quadrature decoders host simulation (C version)
+// Author: dimakomplekt
+// Description: Synthetic (CLK, DT) waveform generator at the increasing speeds (with the acceleration, the stop and
+// the direction change) and the jittered polling:
+// spin and final position errors, recovered and ambiguous skipped states and the wrong-direction detents of each decoder
+// (the recovery must be no worse than the plain quadrature at every speed), the pause case (the velocity estimate must
+// restart after the idle time) and the reversal without the pause.
+// Build: see sim_platform.h
+
+// =========================================================================================== INFO
+
+
+// =========================================================================================== IMPORT
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "encoder_control.h"
+#include "sim_platform.h"
+
+// =========================================================================================== IMPORT
+
+
+// =========================================================================================== DEFINES
+
+#define SIM_CLK GPIO_NUM_14
+#define SIM_DT  GPIO_NUM_12
+
+#define SIM_POLL_PERIOD_US  500  // Nominal polling period (2 kHz)
+#define SIM_POLL_JITTER     20   // Polling period jitter (+/- percents)
+#define SIM_SPIN_DETENTS    200  // Detents forward, then the same number backward
+#define SIM_SLOW_STEP_US    2000   // Quarter step time at the spin start and stop
+#define SIM_RAMP_STEPS      40     // Acceleration and deceleration length (quarter steps)
+#define SIM_PAUSE_US        30000  // Pause before the direction change
+
+// =========================================================================================== DEFINES
+
+
+// =========================================================================================== SIMULATION
+
+// Struct: sim_result
+// Purpose: Stores the one run results
+typedef struct sim_result
+{
+
+    int32_t spin_error; // Position error after the forward spin (detents)
+    int32_t position_error; // Final position error (detents)
+    uint32_t recovered; // Recovered skipped states
+    uint32_t ambiguous; // Dropped skipped states
+    uint32_t wrong_direction; // Detents, reported against the waveform direction
+
+} sim_result;
+
+
+// Deterministic jitter source (LCG)
+static uint32_t sim_random(uint32_t *seed)
+{
+    *seed = *seed * 1664525u + 1013904223u;
+    return *seed >> 8;
+}
+
+
+// Waveform schedule: SIM_SPIN_DETENTS forward, the pause, then the same backward. Each spin accelerates from
+// SIM_SLOW_STEP_US to the selected quarter step time and decelerates before the stop (SIM_RAMP_STEPS quarter steps)
+static int64_t step_times_us[SIM_SPIN_DETENTS * 8];
+
+static void sim_waveform_build(uint32_t quarter_step_us)
+{
+    int spin_steps = SIM_SPIN_DETENTS * 4;
+    int64_t time_us = 0;
+
+    for (int spin = 0; spin < 2; spin++)
+    {
+        for (int step = 0; step < spin_steps; step++)
+        {
+            int edge_distance = (step < spin_steps - 1 - step) ? step : spin_steps - 1 - step;
+            int64_t interval_us = SIM_SLOW_STEP_US - (int64_t)edge_distance * (SIM_SLOW_STEP_US - (int64_t)quarter_step_us) / SIM_RAMP_STEPS;
+
+            if (interval_us < quarter_step_us) interval_us = quarter_step_us;
+
+            time_us += interval_us;
+            step_times_us[spin * spin_steps + step] = time_us;
+        }
+
+        time_us += SIM_PAUSE_US;
+    }
+}
+
+
+// Waveform position (quarter steps) and direction by the time from the start
+static int32_t sim_waveform(int64_t since_start_us, int8_t *direction)
+{
+    int spin_steps = SIM_SPIN_DETENTS * 4;
+    int steps = 0;
+
+    while (steps < 2 * spin_steps && step_times_us[steps] <= since_start_us) steps++;
+
+    *direction = (steps <= spin_steps) ? 1 : -1;
+
+    return (steps <= spin_steps) ? steps : 2 * spin_steps - steps;
+}
+
+
+// One run of the decoder at the selected speed
+static sim_result sim_run(encoder_decoder_mode mode, uint32_t quarter_step_us)
+{
+    sim_reset();
+    sim_quadrature_set(SIM_CLK, SIM_DT, 0);
+
+    encoder_ctx encoder;
+    encoder_initialization(&encoder, GPIO_PIN_NONE, GPIO_PIN_NONE, GPIO_PIN_NONE, SIM_DT, SIM_CLK);
+    encoder_decoder_setup(&encoder, mode);
+
+    sim_result result = {0};
+    uint32_t seed = 12345;
+    int64_t start_us = sim_now_us;
+
+    sim_waveform_build(quarter_step_us);
+    int64_t end_us = start_us + step_times_us[SIM_SPIN_DETENTS * 8 - 1] + SIM_PAUSE_US;
+
+    // Middle of the pause after the forward spin
+    int64_t spin_end_us = start_us + step_times_us[SIM_SPIN_DETENTS * 4 - 1] + SIM_PAUSE_US / 2;
+    bool spin_checked = false;
+
+    while (sim_now_us < end_us)
+    {
+        int8_t direction;
+        sim_quadrature_set(SIM_CLK, SIM_DT, sim_waveform(sim_now_us - start_us, &direction));
+
+        int8_t rotation = enc_position_control(&encoder);
+        if (rotation != 0 && rotation != direction) result.wrong_direction++;
+
+        if (!spin_checked && sim_now_us >= spin_end_us)
+        {
+            result.spin_error = encoder.position - SIM_SPIN_DETENTS;
+            spin_checked = true;
+        }
+
+        // Jittered poll period
+        int32_t jitter_us = (int32_t)(sim_random(&seed) % (2 * SIM_POLL_PERIOD_US * SIM_POLL_JITTER / 100 + 1)) -
+                            SIM_POLL_PERIOD_US * SIM_POLL_JITTER / 100;
+        sim_now_us += SIM_POLL_PERIOD_US + jitter_us;
+    }
+
+    result.position_error = encoder.position;
+    result.recovered = encoder.recovered_steps;
+    result.ambiguous = encoder.ambiguous_steps;
+
+    return result;
+}
+
+
+// Spin, long pause, two steps, then the reverse skipped state: it must be dropped, not recovered in the old direction
+static bool sim_pause_reverse(void)
+{
+    sim_reset();
+    sim_quadrature_set(SIM_CLK, SIM_DT, 0);
+
+    encoder_ctx encoder;
+    encoder_initialization(&encoder, GPIO_PIN_NONE, GPIO_PIN_NONE, GPIO_PIN_NONE, SIM_DT, SIM_CLK);
+    encoder_decoder_setup(&encoder, ENC_DECODER_QUADRATURE_RECOVERY);
+
+    int32_t quarter_steps = 0;
+
+    // 40 quarter steps at 1 ms
+    for (int i = 0; i < 40; i++)
+    {
+        sim_now_us += 1000;
+        sim_quadrature_set(SIM_CLK, SIM_DT, ++quarter_steps);
+        enc_position_control(&encoder);
+    }
+
+    // 10 s idle, then 2 quarter steps
+    sim_now_us += 10000000;
+
+    for (int i = 0; i < 2; i++)
+    {
+        sim_now_us += 1000;
+        sim_quadrature_set(SIM_CLK, SIM_DT, ++quarter_steps);
+        enc_position_control(&encoder);
+    }
+
+    // Reverse skipped state 100 ms later
+    sim_now_us += 100000;
+    quarter_steps -= 2;
+    sim_quadrature_set(SIM_CLK, SIM_DT, quarter_steps);
+    enc_position_control(&encoder);
+
+    printf("pause + reverse jump: step interval %u us, recovered %u, ambiguous %u\n",
+           (unsigned)encoder.step_interval_us, (unsigned)encoder.recovered_steps, (unsigned)encoder.ambiguous_steps);
+
+    return encoder.recovered_steps == 0 && encoder.ambiguous_steps == 1;
+}
+
+
+
+// Reversal without the pause: 10 detents forward and 10 back at the 1 ms quarter step, then 10 more back at 400 us
+// (skipped states) - the reversal must be taken, the skipped states are recovered in the new direction
+static bool sim_fast_reverse(void)
+{
+    sim_reset();
+    sim_quadrature_set(SIM_CLK, SIM_DT, 0);
+
+    encoder_ctx encoder;
+    encoder_initialization(&encoder, GPIO_PIN_NONE, GPIO_PIN_NONE, GPIO_PIN_NONE, SIM_DT, SIM_CLK);
+    encoder_decoder_setup(&encoder, ENC_DECODER_QUADRATURE_RECOVERY);
+
+    int64_t start_us = sim_now_us;
+    int64_t step_us = 0;
+    int count = 0;
+
+    for (int step = 0; step < 120; step++)
+    {
+        step_us += (step < 80) ? 1000 : 400;
+        step_times_us[count++] = step_us;
+    }
+
+    uint32_t wrong_direction = 0;
+
+    while (sim_now_us - start_us < step_us + 20000)
+    {
+        int steps = 0;
+        while (steps < count && step_times_us[steps] <= sim_now_us - start_us) steps++;
+
+        int8_t direction = (steps <= 40) ? 1 : -1;
+        sim_quadrature_set(SIM_CLK, SIM_DT, (steps <= 40) ? steps : 80 - steps);
+
+        int8_t rotation = enc_position_control(&encoder);
+        if (rotation != 0 && rotation != direction) wrong_direction++;
+
+        sim_now_us += SIM_POLL_PERIOD_US;
+    }
+
+    printf("reverse without the pause: position %d (expected -10), recovered %u, ambiguous %u, wrong direction %u\n",
+           (int)encoder.position, (unsigned)encoder.recovered_steps, (unsigned)encoder.ambiguous_steps, (unsigned)wrong_direction);
+
+    return encoder.position == -10 && wrong_direction == 0;
+}
+
+// =========================================================================================== SIMULATION
+
+
+// =========================================================================================== MAIN
+
+int main(void)
+{
+    static const uint32_t quarter_steps_us[] = { 2000, 1000, 700, 500, 400, 320, 250, 200, 150 };
+    static const char *mode_names[] = { "clk edge", "quadrature", "recovery" };
+
+    // Longest poll gap with the jitter - up to 2 states per poll are recoverable
+    uint32_t max_gap_us = SIM_POLL_PERIOD_US * (100 + SIM_POLL_JITTER) / 100;
+    bool passed = true;
+
+    printf("poll %u us +/- %u%%, %u detents forward and back\n", SIM_POLL_PERIOD_US, SIM_POLL_JITTER, SIM_SPIN_DETENTS);
+
+    for (size_t i = 0; i < sizeof(quarter_steps_us) / sizeof(quarter_steps_us[0]); i++)
+    {
+        uint32_t quarter_step_us = quarter_steps_us[i];
+
+        printf("quarter step %4u us (%4u detents/s):\n", quarter_step_us, 250000 / quarter_step_us);
+
+        sim_result quadrature = {0};
+
+        for (int mode = ENC_DECODER_CLK_EDGE; mode <= ENC_DECODER_QUADRATURE_RECOVERY; mode++)
+        {
+            sim_result result = sim_run((encoder_decoder_mode)mode, quarter_step_us);
+
+            printf("    %-10s spin error %4d, position error %4d, recovered %4u, ambiguous %4u, wrong direction %4u\n", mode_names[mode],
+                   (int)result.spin_error, (int)result.position_error, (unsigned)result.recovered, (unsigned)result.ambiguous,
+                   (unsigned)result.wrong_direction);
+
+            // Expected exact decoding: every state seen by the quadrature decoders, at most one skipped state for the recovery
+            bool exact = (mode == ENC_DECODER_QUADRATURE && quarter_step_us > max_gap_us) ||
+                         (mode == ENC_DECODER_QUADRATURE_RECOVERY && quarter_step_us * 2 > max_gap_us);
+
+            if (exact && (result.position_error != 0 || result.wrong_direction != 0)) passed = false;
+
+            // Recovery at any speed is no worse than the plain quadrature: the error of each spin (the final error alone
+            // hides the dropped states - the same number is dropped by the forward and the backward spin) and the
+            // wrong-direction detents
+            if (mode == ENC_DECODER_QUADRATURE) quadrature = result;
+
+            if (mode == ENC_DECODER_QUADRATURE_RECOVERY &&
+                (abs(result.spin_error) > abs(quadrature.spin_error) ||
+                 abs(result.position_error - result.spin_error) > abs(quadrature.position_error - quadrature.spin_error) ||
+                 result.wrong_direction > quadrature.wrong_direction)) passed = false;
+        }
+    }
+
+    passed = sim_pause_reverse() && passed;
+    passed = sim_fast_reverse() && passed;
+
+    printf("%s\n", passed ? "PASSED" : "FAILED");
+
+    return passed ? 0 : 1;
+}
+
+// =========================================================================================== MAIN
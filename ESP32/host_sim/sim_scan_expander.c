@@ -0,0 +1,203 @@
+// =========================================================================================== INFO
+
+// Encoder scan bus host simulation (C version)
+// Author: dimakomplekt
+// Description: Simulated I2C expander on the encoder_scan_bus_user_init backend. The burst takes the bus time
+// (frame + 9 clocks per byte at the bus clock), all the encoders spin at the target detent rate with the different
+// phases, and the decoded detents are compared with the encoder_scan_bus_capacity limits: the bus limit for the quadrature
+// decoder, then the default CLK edge decoder against its debounce limit (max_detent_rate_clk_edge_hz).
+// The decoding time of the MCU is not modeled - only the bus time.
+// Build: see sim_platform.h
+
+// =========================================================================================== INFO
+
+
+// =========================================================================================== IMPORT
+
+#include <stdio.h>
+#include "encoder_control.h"
+#include "sim_platform.h"
+
+// =========================================================================================== IMPORT
+
+
+// =========================================================================================== DEFINES
+
+#define SIM_BUS_CLOCK_HZ       400000  // I2C fast mode
+#define SIM_CLOCKS_PER_BYTE    9       // 8 data bits + ACK
+#define SIM_FRAME_CLOCKS       11      // Start + address byte with ACK + stop
+#define SIM_LINES_PER_ENCODER  3       // SW, DT, CLK
+#define SIM_DETENT_RATE_HZ     1500    // Target detent rate per encoder (quadrature decoder)
+#define SIM_CLK_EDGE_RATE_HZ   300     // Detent rate inside the CLK edge decoder limit
+#define SIM_DETENTS            600     // Detents per encoder in the run
+#define SIM_MAX_ENCODERS       (ENC_SCAN_BUS_MAX_LINES / SIM_LINES_PER_ENCODER)
+
+// =========================================================================================== DEFINES
+
+
+// =========================================================================================== SIMULATED EXPANDER
+
+// Struct: sim_expander
+// Purpose: Stores the simulated expander lines source - encoders, spinning with the constant speed
+typedef struct sim_expander
+{
+
+    int encoders; // Spinning encoders number
+    uint32_t detent_rate_hz; // Detent rate of the spins
+    uint32_t burst_ns; // Burst time by the bus clock
+    int64_t burst_remainder_ns; // Burst time part below one microsecond
+
+} sim_expander;
+
+
+// Encoder trace: quarter steps by the time, phase offset by the encoder number, SIM_DETENTS detents and stop
+static int32_t sim_trace_quarter_steps(int encoder, uint32_t detent_rate_hz, int64_t time_us)
+{
+    int64_t quarter_step_ns = 1000000000LL / (detent_rate_hz * 4);
+    int64_t since_start_ns = time_us * 1000 - 1000000 - (quarter_step_ns * encoder) / 7;
+
+    if (since_start_ns < 0) return 0;
+
+    int64_t quarter_steps = since_start_ns / quarter_step_ns;
+
+    return (quarter_steps > SIM_DETENTS * 4) ? SIM_DETENTS * 4 : (int32_t)quarter_steps;
+}
+
+
+// Burst read: lines sampled after the address byte, then the bus time passes
+static bool sim_expander_read(void *user_data, uint8_t *buffer, size_t size)
+{
+    sim_expander *expander = user_data;
+
+    for (size_t i = 0; i < size; i++) buffer[i] = 0xFF;
+
+    for (int encoder = 0; encoder < expander->encoders; encoder++)
+    {
+        static const uint8_t clk_levels[4] = { 0, 1, 1, 0 };
+        static const uint8_t dt_levels[4] = { 0, 0, 1, 1 };
+
+        int phase = sim_trace_quarter_steps(encoder, expander->detent_rate_hz, sim_now_us) & 0x3;
+        int dt_line = encoder * SIM_LINES_PER_ENCODER + 1;
+        int clk_line = encoder * SIM_LINES_PER_ENCODER + 2;
+
+        if (!dt_levels[phase]) buffer[dt_line >> 3] &= (uint8_t)~(1u << (dt_line & 7));
+        if (!clk_levels[phase]) buffer[clk_line >> 3] &= (uint8_t)~(1u << (clk_line & 7));
+    }
+
+    // Bus time with the sub-microsecond remainder
+    expander->burst_remainder_ns += expander->burst_ns;
+    sim_now_us += expander->burst_remainder_ns / 1000;
+    expander->burst_remainder_ns %= 1000;
+
+    return true;
+}
+
+// =========================================================================================== SIMULATED EXPANDER
+
+
+// =========================================================================================== SIMULATION
+
+// One run with the selected encoders number, detent rate and decoder: lost detents of all the encoders and the measured scan rate
+static int32_t sim_run(int encoders, uint32_t detent_rate_hz, encoder_decoder_mode mode, uint32_t *scan_rate_hz)
+{
+    sim_reset();
+
+    sim_expander expander = { .encoders = encoders, .detent_rate_hz = detent_rate_hz };
+    encoder_scan_bus bus;
+    encoder_scan_bus_user_init(&bus, sim_expander_read, &expander, (uint16_t)(encoders * SIM_LINES_PER_ENCODER),
+                               SIM_CLOCKS_PER_BYTE, SIM_FRAME_CLOCKS);
+
+    expander.burst_ns = (uint32_t)((uint64_t)bus.burst_clocks * 1000000000ULL / SIM_BUS_CLOCK_HZ);
+
+    encoder_ctx bank[SIM_MAX_ENCODERS];
+    encoder_scan_bus_read(&bus);
+
+    for (int i = 0; i < encoders; i++)
+    {
+        encoder_initialization(&bank[i], GPIO_PIN_NONE, GPIO_PIN_NONE, GPIO_PIN_NONE, GPIO_PIN_NONE, GPIO_PIN_NONE);
+        encoder_scan_attach(&bank[i], &bus, i * SIM_LINES_PER_ENCODER, i * SIM_LINES_PER_ENCODER + 1, i * SIM_LINES_PER_ENCODER + 2);
+        encoder_decoder_setup(&bank[i], mode);
+    }
+
+    // Continuous scan until all the spins are finished
+    int64_t start_us = sim_now_us;
+    uint32_t start_scans = bus.scans;
+    int64_t end_us = 1000 + (int64_t)SIM_DETENTS * 1000000 / detent_rate_hz + encoders + 10000;
+
+    while (sim_now_us < end_us)
+    {
+        encoder_scan_bus_read(&bus);
+        for (int i = 0; i < encoders; i++) enc_position_control(&bank[i]);
+    }
+
+    *scan_rate_hz = (uint32_t)((uint64_t)(bus.scans - start_scans) * 1000000 / (uint64_t)(sim_now_us - start_us));
+
+    int32_t lost = 0;
+    for (int i = 0; i < encoders; i++) lost += SIM_DETENTS - bank[i].position;
+
+    return lost;
+}
+
+// =========================================================================================== SIMULATION
+
+
+// =========================================================================================== MAIN
+
+int main(void)
+{
+    // Capacity of the full buffer bus
+    sim_expander expander = {0};
+    encoder_scan_bus bus;
+    encoder_scan_bus_user_init(&bus, sim_expander_read, &expander, ENC_SCAN_BUS_MAX_LINES, SIM_CLOCKS_PER_BYTE, SIM_FRAME_CLOCKS);
+
+    encoder_scan_capacity capacity;
+    encoder_scan_bus_capacity(&bus, SIM_BUS_CLOCK_HZ, SIM_LINES_PER_ENCODER, SIM_DETENT_RATE_HZ, &capacity);
+
+    printf("I2C %u kHz, %d detents/s per encoder: bus limit %u encoders, buffer limit %u encoders\n",
+           SIM_BUS_CLOCK_HZ / 1000, SIM_DETENT_RATE_HZ, capacity.max_encoders, capacity.max_encoders_buffer);
+
+    bool passed = true;
+
+    for (int encoders = 2; encoders <= SIM_MAX_ENCODERS; encoders++)
+    {
+        encoder_scan_bus_user_init(&bus, sim_expander_read, &expander, (uint16_t)(encoders * SIM_LINES_PER_ENCODER),
+                                   SIM_CLOCKS_PER_BYTE, SIM_FRAME_CLOCKS);
+
+        encoder_scan_capacity run_capacity;
+        encoder_scan_bus_capacity(&bus, SIM_BUS_CLOCK_HZ, SIM_LINES_PER_ENCODER, SIM_DETENT_RATE_HZ, &run_capacity);
+
+        uint32_t scan_rate_hz;
+        int32_t lost = sim_run(encoders, SIM_DETENT_RATE_HZ, ENC_DECODER_QUADRATURE, &scan_rate_hz);
+        bool within_limit = encoders <= capacity.max_encoders;
+
+        printf("%2d encoders: burst %6u ns, scan rate %5u Hz (predicted %5u), lost detents %5d%s\n",
+               encoders, run_capacity.burst_ns, scan_rate_hz, run_capacity.max_scan_rate_hz, (int)lost,
+               within_limit ? "" : "  (over the bus limit)");
+
+        // No losses inside the bus limit
+        if (within_limit && lost != 0) passed = false;
+    }
+
+    // Default CLK edge decoder: the bus limit target is above its debounce limit, the lower rate is followed up to the buffer limit
+    printf("CLK edge decoder: detent rate limit %u detents/s (quadrature %u)\n",
+           capacity.max_detent_rate_clk_edge_hz, capacity.max_detent_rate_hz);
+
+    uint32_t scan_rate_hz;
+    int32_t lost = sim_run(2, SIM_DETENT_RATE_HZ, ENC_DECODER_CLK_EDGE, &scan_rate_hz);
+
+    printf(" 2 encoders, %4d detents/s: lost detents %5d (over the CLK edge limit)\n", SIM_DETENT_RATE_HZ, (int)lost);
+
+    if (lost == 0 || SIM_DETENT_RATE_HZ <= capacity.max_detent_rate_clk_edge_hz) passed = false;
+
+    lost = sim_run(capacity.max_encoders_buffer, SIM_CLK_EDGE_RATE_HZ, ENC_DECODER_CLK_EDGE, &scan_rate_hz);
+
+    printf("%2d encoders, %4d detents/s: lost detents %5d\n", capacity.max_encoders_buffer, SIM_CLK_EDGE_RATE_HZ, (int)lost);
+
+    if (lost != 0) passed = false;
+
+    printf("%s\n", passed ? "PASSED" : "FAILED");
+
+    return passed ? 0 : 1;
+}
+
+// =========================================================================================== MAIN
@@ -0,0 +1,9 @@
+// Host simulation stub: GPIO wakeup source of the light sleep
+#ifndef SIM_ESP_SLEEP_H
+#define SIM_ESP_SLEEP_H
+
+#include "driver/gpio.h"
+
+esp_err_t esp_sleep_enable_gpio_wakeup(void);
+
+#endif // SIM_ESP_SLEEP_H
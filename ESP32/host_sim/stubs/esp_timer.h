@@ -0,0 +1,9 @@
+// Host simulation stub: esp_timer time base (simulated time, sim_platform.c)
+#ifndef SIM_ESP_TIMER_H
+#define SIM_ESP_TIMER_H
+
+#include <stdint.h>
+
+int64_t esp_timer_get_time(void);
+
+#endif // SIM_ESP_TIMER_H
@@ -0,0 +1,22 @@
+// Host simulation stub: async_await library subset (time checks by the simulated time)
+#ifndef SIM_ASYNC_AWAIT_H
+#define SIM_ASYNC_AWAIT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum { TIME_UNIT_US, TIME_UNIT_MS, TIME_UNIT_S } time_unit;
+
+typedef struct async_await_ctx
+{
+
+    int64_t start_us; // Waiting start time
+    bool started; // Waiting is started
+
+} async_await_ctx;
+
+async_await_ctx async_await_ctx_default(void);
+bool async_await(async_await_ctx *ctx, long value, time_unit unit, bool restart);
+void await(long value, time_unit unit);
+
+#endif // SIM_ASYNC_AWAIT_H
@@ -0,0 +1,21 @@
+// Host simulation stub: button_control library subset (one-time press flag by the pin level)
+#ifndef SIM_BUTTON_CONTROL_H
+#define SIM_BUTTON_CONTROL_H
+
+#include <stdbool.h>
+#include "driver/gpio.h"
+
+typedef enum { NO_FIX, FIX } fix_mode;
+
+typedef struct button_ctx
+{
+
+    gpio_num_t pin; // Button pin (pressed - low level)
+    bool last_pressed; // Last pressed state
+
+} button_ctx;
+
+button_ctx button_initialization(gpio_num_t pin, gpio_pull_mode_t pull, fix_mode mode);
+void flag_control_by_but_onetime_press(button_ctx *button, bool *flag);
+
+#endif // SIM_BUTTON_CONTROL_H
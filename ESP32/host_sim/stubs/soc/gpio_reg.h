@@ -0,0 +1,4 @@
+// Host simulation stub: the registers are accessed by the gpio_dev_t struct only (soc/gpio_struct.h)
+#ifndef SIM_SOC_GPIO_REG_H
+#define SIM_SOC_GPIO_REG_H
+#endif // SIM_SOC_GPIO_REG_H
@@ -0,0 +1,21 @@
+// Host simulation stub: the ESP32 GPIO registers subset (input and output set/clear registers)
+#ifndef SIM_SOC_GPIO_STRUCT_H
+#define SIM_SOC_GPIO_STRUCT_H
+
+#include <stdint.h>
+
+typedef struct gpio_dev_t
+{
+
+    volatile uint32_t out_w1ts;
+    volatile uint32_t out_w1tc;
+    struct { volatile uint32_t val; } out1_w1ts;
+    struct { volatile uint32_t val; } out1_w1tc;
+    volatile uint32_t in;
+    struct { volatile uint32_t val; } in1;
+
+} gpio_dev_t;
+
+extern gpio_dev_t GPIO;
+
+#endif // SIM_SOC_GPIO_STRUCT_H